@@ -4,7 +4,8 @@
 // Chapter: DMA
 // Code description: this code uses the CPU Timer 0 to trigger the DMA Transfer. The DMA is programmed to take 3 fixed locations,
 // that can be mapped registers such as CMPSS Registers, and transfer the data to 3 memory locations.
-// This example uses PING-PONG buffering, requiring 2*3 blocks of memory.
+// This example uses PING-PONG style buffering over CAPTURE_BLOCKS blocks of 3*TRANSFER words, handed to the
+// main loop in place (buf_pool.h).
 // Testing: Open a graph and observe the memories: at location rData
 // Open a graph window and import "rData_display.graphProp" to visualize the data.
 //#############################################################################
@@ -12,6 +13,12 @@
 #include "sysctl.h"
 #include "driverlib.h"
 #include "device.h"
+#include "dma_health.h"
+#include "dma_copy.h"
+#include "dma_chain.h"
+#include "buf_pool.h"
+#include "rate_gen.h"
+#include "isr_prof.h"
 #include <sys/types.h>
 #include <time.h>
 #include <stdio.h>
@@ -36,12 +43,20 @@
 // Total number of words moved in one transfer (3 channels × TRANSFER frames)
 #define DMA_Transfer   (TRANSFER * 3)
 
-// Two frames (PING and PONG), each of size DMA_Transfer
-#define rData_length   DMA_Transfer * 2
+// Capture blocks rotated through by the DMA (PING, PONG, ...), each of size
+// DMA_Transfer. More than two lets the consumer hold a block while the DMA
+// keeps going.
+#define CAPTURE_BLOCKS 4
+#define rData_length   (DMA_Transfer * CAPTURE_BLOCKS)
 
 // For plotting convenience.
 #define SAMPLES        TRANSFER
 
+// ISR latency / execution-time slots in isrProf.slot[] (isr_prof.h).
+// Build with ISR_PROF_ENABLE=0 to compile the instrumentation out.
+#define ISR_ID_DMA_CH1     0      // Latency from the Timer 0 trigger of the last burst
+#define ISR_ID_TIMER0      1
+
 //---------------------------------------------------------------------------
 // Globals
 //---------------------------------------------------------------------------
@@ -50,25 +65,39 @@
 uint16_t sData[100];
 uint16_t rData[rData_length];
 
-// Ping-pong flag (1 = update first half of rData)
-int pingpong = 1;
-
 // Timer debug counters: incremented in the timer ISRs
 uint16_t cpuTimer0IntCount;
 
 uint32_t sysClockFreq = 0;  // Will hold system clock frequency at run-time
 
-// These pointers hold the base addresses for DMA source and destination
-const void *destAddr1;
-const void *destAddr2;
-const void *srcAddr;
+// Timer 0 trigger rate: exact integer period, achieved rate in sampleRate.achievedHz
+RateGen sampleRate;
+
+// Capture transfer as a single looping descriptor; the destination is
+// re-pointed at the next free block of capturePool before every reload.
+//  -- Burst: size = 3 , srcStep = 30, destSTep = 152
+//  -- Transfer: size = 152, srcStep = 0, destStep = -303
+//  -- Wrap: srcSize = 1 -> wrap at the top of the sData after each burst, to continuously read the sData[0], sData[30] and sData[60]
+// The 3 channels land de-interleaved: each block is 3 planes of TRANSFER words.
+DMAChain_Descriptor captureList[1] =
+{
+    // src,  dst,  burst,  30, 152, transfer,  0, -303, src wrap, step, dst wrap,          step
+    { sData, NULL, BURST,  30, 152, TRANSFER,  0, -303, 1,        0,    DMA_CHAIN_NO_WRAP, 0 },
+};
+
+// Blocks of rData handed to the main loop without copying
+BufPool capturePool;
+BufDesc captureDesc[CAPTURE_BLOCKS];
+BufDesc *captureBlock;      // Block the DMA is filling
+
+// Channel 1 descriptor walker; reload timing in captureChain.reloadCyclesMax
+DMAChain captureChain;
 
 //---------------------------------------------------------------------------
 // Function Prototypes
 //---------------------------------------------------------------------------
 void initDMA(void);
 void initCPUTimers(void);
-void configCPUTimer(uint32_t cpuTimer, float freq, float trigger_freq);
 __interrupt void dmaCh1ISR(void);
 __interrupt void cpuTimer0ISR(void);
 
@@ -78,45 +107,51 @@ __interrupt void cpuTimer0ISR(void);
 //---------------------------------------------------------------------------
 void main(void)
 {
-    int i;
-
-    // Map the C arrays to generic pointers expected by the DMA driverlib API
-    srcAddr  = &sData[0];
-    destAddr1 = &rData[0]; // Ping Region: 0 -> 455
-    destAddr2 = &rData[456]; // Pong Region: 456 -> 911
-
-
     // Initialize the device
     Device_init();
 
     // Reset and configure the DMA controller
     initDMA();
 
+    // ISR statistics, stamped from the free-running timer of dma_chain
+    ISR_PROF_INIT(DMA_CHAIN_TIMESTAMP_BASE);
+
+    // Overrun / missed-trigger / consumer-lag counters for the capture ring
+    dma_health_init(DMA_CH1_BASE, &capturePool, TRANSFER);
+
+    // Channel 6: software-triggered bulk copies (dma_memcpy/dma_memset).
+    // Channel 1 gets fixed high priority: a capture trigger suspends a copy
+    // after its current word, not its current burst.
+    DMA_setPriorityMode(true);
+    dma_copy_init(DMA_CH6_BASE);
+
     // Initialize and configure the CPU timer 0 -> generates DMA triggers
     initCPUTimers();
     sysClockFreq = SysCtl_getClock(DEVICE_OSCSRC_FREQ); // DEVICE_OSCSRC_FREQ = 20MHz (open declaration)
 
-    // Configure Timer 0 at 8 kHz (trigger_freq argument is in Hz)
-    configCPUTimer(CPUTIMER0_BASE, sysClockFreq, 8000.0f);
+    // Configure Timer 0 at 8 kHz: 8000/1 Hz, period computed in integers,
+    // fractional remainder (if any) dithered from cpuTimer0ISR
+    if (!rate_gen_init(&sampleRate, CPUTIMER0_BASE, sysClockFreq, 8000, 1, true))
+    {
+        ESTOP0;     // Rate above the timer clock
+    }
 
 
-    // Initialize buffers:
+    // Initialize buffers (DMA channel 6, CPU stays free):
     //  - sData is filled with 1s except of the measurements indices, sData[0], sData[30], sData[60]
     //  - rData is initially set to 0 and later filled by DMA
-    for (i = 0; i < 912; i++)
-    {
-        rData[i] = 0;
-    }
-
-    for (i = 0; i < 100; i++)
-        {
-            sData[i] = 1;
-        }
+    dma_memset(rData, 0, rData_length);
+    dma_memset(sData, 1, 100);
 
     sData[0] = 0;
     sData[30] = 30;
     sData[60] = 60;
 
+#ifdef DMA_COPY_RUN_BENCHMARK
+    // CPU vs DMA copy times -> dmaCopyBench (view in the Expressions window)
+    dma_copy_benchmark();
+#endif
+
 
     // Initialize PIE and CPU interrupt system
     Interrupt_initModule();
@@ -125,6 +160,9 @@ void main(void)
     // Register DMA Channel 1 ISR.
     Interrupt_register(INT_DMA_CH1, &dmaCh1ISR);
 
+    // Register DMA Channel 6 (copy engine) ISR for the async copy callbacks.
+    Interrupt_register(INT_DMA_CH6, &dma_copy_isr);
+
     // Make sure DMA traffic goes through Peripheral Frame 2 bridge
     SysCtl_selectSecMaster(0, SYSCTL_SEC_MASTER_DMA);
 
@@ -133,6 +171,7 @@ void main(void)
 
     // Enable peripheral interrupts in the PIE.
     Interrupt_enable(INT_DMA_CH1);
+    Interrupt_enable(INT_DMA_CH6);
     CPUTimer_enableInterrupt(CPUTIMER0_BASE);
     Interrupt_enable(INT_TIMER0);
 
@@ -148,7 +187,18 @@ void main(void)
 
     while (1)
     {
+        // Consumer: take a finished block of rData in place. Its 3 channels
+        // are contiguous planes: bufdesc_channel(block, 0..2), TRANSFER
+        // samples each. The DMA never writes a block until it is released;
+        // holding too many shows up in dmaHealth.consumerOverruns.
+        BufDesc *block = buf_pool_acquire(&capturePool);
+
+        if (block != NULL)
+        {
+            // Processing goes here.
 
+            buf_pool_release(&capturePool, block);
+        }
     }
 }
 
@@ -158,21 +208,19 @@ void main(void)
 //---------------------------------------------------------------------------
 __interrupt void dmaCh1ISR(void)
 {
-    // Checks the value of the Ping-Pong flag
+    ISR_PROF_ENTER(ISR_ID_DMA_CH1, ISR_PROF_TIMER_AGE(CPUTIMER0_BASE));
 
-    if (pingpong == 1)
-            {
-                pingpong = 0; // Toggle the Ping-Pong flag
-                DMA_configAddresses(DMA_CH1_BASE, destAddr2, srcAddr); // Change destination address of the buffer, to switch between the two halves of rData[]
-            }
-    else
-            {
-                pingpong = 1; // Toggle the Ping-Pong flag
-                DMA_configAddresses(DMA_CH1_BASE, destAddr1, srcAddr); // Change destination address of the buffer, to switch between the two halves of rData[]
+    // Hand the finished block over and point the next transfer at a free one.
+    // Done first: the reload has to finish before the next Timer 0 trigger.
+    captureBlock = buf_pool_rotate(&capturePool, captureBlock);
+    captureList[0].dst = captureBlock->data;
+    dma_chain_onTransferEnd(&captureChain);
 
-            }
+    // Account for the finished block
+    dma_health_onBlock(cpuTimer0IntCount);
 
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);   // Clear PIE group 7 flag
+    ISR_PROF_EXIT(ISR_ID_DMA_CH1);
     return;
 }
 
@@ -185,37 +233,23 @@ void initDMA(void)
     // Perform a HARD reset of the DMA controller and return it to its power-up state (clears all channel configs).
     DMA_initController();
 
-    // Configure source and destination base addresses for Channel 1.
-    DMA_configAddresses(DMA_CH1_BASE, destAddr1, srcAddr);
-
-    // Configure a transfer consisting of TRANSFER elements.
-    // -- Burst: size = 3 , srcStep = 30, destSTep = 152
-    // -- Transfer: size = 152, srcStep = 0, destStep = -303
-    // -- Wrap: srcSize = 1 (all other parameters set to zero) -> wrap at the top of the sData after each burst, to continuously read the sData[0], sData[30] and sData[60]
-    DMA_configBurst(DMA_CH1_BASE, BURST, 30, 152);
-    DMA_configTransfer(DMA_CH1_BASE, TRANSFER, 0, -303);
-    DMA_configWrap(DMA_CH1_BASE, 1, 0, 0, 0);
-
-
     // Configure DMA triggering and behavior:
     //  - Trigger source: Timer 0 interrupt (TINT0)
-    //  - ONESHOT disabled: DMA runs continuously (restarts automatically)
-    //  - CONTINUOUS enabled: keeps transferring on every trigger
+    //  - ONESHOT disabled: one burst per trigger
+    //  - CONTINUOUS enabled (added by dma_chain_init): keeps transferring on every trigger
     //  - SIZE_16BIT: moves 16-bit words.
-    DMA_configMode(DMA_CH1_BASE,
-                   DMA_TRIGGER_TINT0,
-                   DMA_CFG_ONESHOT_DISABLE |
-                   DMA_CFG_CONTINUOUS_ENABLE |
-                   DMA_CFG_SIZE_16BIT);
-
-    // Generate DMA interrupt at the end of the transfer.
-    DMA_setInterruptMode(DMA_CH1_BASE, DMA_INT_AT_END);
-
-    // Allow DMA Channel 1 to respond to triggers.
-    DMA_enableTrigger(DMA_CH1_BASE);
-
-    // Enable DMA Channel 1 interrupt in the controller.
-    DMA_enableInterrupt(DMA_CH1_BASE);
+    // The first block comes straight from the pool; later ones from the ISR.
+    buf_pool_init(&capturePool, captureDesc, rData, CAPTURE_BLOCKS,
+                  3, TRANSFER, TRANSFER, 1);
+    captureBlock = buf_pool_startFill(&capturePool);
+    captureList[0].dst = captureBlock->data;
+
+    dma_chain_init(&captureChain, DMA_CH1_BASE, DMA_TRIGGER_TINT0,
+                   DMA_CFG_ONESHOT_DISABLE | DMA_CFG_SIZE_16BIT,
+                   captureList, 1, true);
+
+    // dma_chain_init() also sets the interrupt at the end of each transfer,
+    // enables the trigger and enables the channel interrupt.
 }
 
 
@@ -236,39 +270,17 @@ void initCPUTimers(void)
 }
 
 
-//---------------------------------------------------------------------------
-// Configure an individual CPU timer
-//  - freq: system clock frequency in Hz
-//  - trigger_freq: the desired triggering frequency of the design
-//---------------------------------------------------------------------------
-void configCPUTimer(uint32_t cpuTimer, float freq, float trigger_freq)
-{
-
-    // Convert triggering frequency to period (s)
-    float period = 1 / trigger_freq;
-
-    // Convert desired period (s) to timer ticks.
-    uint32_t temp = (uint32_t)(freq * period);
-
-    CPUTimer_setPeriod(cpuTimer, temp);
-    CPUTimer_setPreScaler(cpuTimer, 0);
-    CPUTimer_stopTimer(cpuTimer);
-    CPUTimer_reloadTimerCounter(cpuTimer);
-
-    // When halted by debugger, timer stops after next decrement.
-    CPUTimer_setEmulationMode(cpuTimer,
-                              CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT);
-}
-
-
 //---------------------------------------------------------------------------
 // CPU Timer 0 ISR
 //---------------------------------------------------------------------------
 // Executed at 8 kHz.
 __interrupt void cpuTimer0ISR(void)
 {
+    ISR_PROF_ENTER(ISR_ID_TIMER0, ISR_PROF_TIMER_AGE(CPUTIMER0_BASE));
     cpuTimer0IntCount++;  // Software counter
+    rate_gen_onTick(&sampleRate);  // Dithered period for the next reload
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);    // Clear PIE group 1 flag
+    ISR_PROF_EXIT(ISR_ID_TIMER0);
 }
 
 
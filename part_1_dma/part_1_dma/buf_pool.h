@@ -0,0 +1,124 @@
+//#############################################################################
+// File: buf_pool.h
+// Chapter: DMA / ADC
+// Code description: ownership-based pool of capture blocks. A producer (DMA
+// or ADC ISR) fills a block in place and hands it over; the consumer gets a
+// pointer to the same memory, processes it in place and releases it back to
+// the pool. No sample is copied between capture and processing.
+//
+// Ownership:  FREE -> FILLING (producer) -> READY -> OWNED (consumer) -> FREE
+// A block in OWNED state is never written by the producer. When no block is
+// free, the producer keeps refilling the block it has just completed (the
+// newest data is dropped) and counts it in BufPool.dropped.
+//
+// The ready and free queues are SPSC rings of block indices (spsc_queue.h):
+// the ISR pushes to readyQ and pops from freeQ, the consumer does the
+// opposite, so no interrupt masking is needed on either side. readyQ's
+// high-water mark is the deepest the consumer has fallen behind.
+//#############################################################################
+
+#ifndef BUF_POOL_H
+#define BUF_POOL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "spsc_queue.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define BUF_POOL_MAX_BLOCKS     8U      // Power of two (ring size)
+
+// Block states (BufDesc.state)
+#define BUF_STATE_FREE          0U
+#define BUF_STATE_FILLING       1U
+#define BUF_STATE_READY         2U
+#define BUF_STATE_OWNED         3U
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// One capture block and its sample layout. Sample f of channel c is
+// data[c * chStride + f * frStride]:
+//  - planar (de-interleaved) blocks: chStride = frames, frStride = 1
+//  - interleaved blocks:             chStride = 1,      frStride = channels
+typedef struct
+{
+    uint16_t *data;
+    uint16_t  channels;
+    uint16_t  frames;           // Samples per channel
+    uint16_t  chStride;
+    uint16_t  frStride;
+    uint16_t  index;            // Position in the pool
+    volatile uint16_t state;    // BUF_STATE_*
+    uint32_t  sequence;         // Hand-over number; gaps mean dropped blocks
+} BufDesc;
+
+typedef struct
+{
+    BufDesc *desc;
+    uint16_t count;
+
+    // Rings of block indices
+    SPSCQueue readyQ;               // Producer -> consumer
+    SPSCQueue freeQ;                // Consumer -> producer
+    uint16_t  readyBuf[BUF_POOL_MAX_BLOCKS];
+    uint16_t  freeBuf[BUF_POOL_MAX_BLOCKS];
+
+    // Statistics (producer side)
+    uint32_t produced;              // Blocks handed to the consumer
+    uint32_t dropped;               // Blocks refilled for lack of a free one
+} BufPool;
+
+//---------------------------------------------------------------------------
+// Layout helpers
+//---------------------------------------------------------------------------
+// Start of one channel; with a planar layout this is a contiguous array of
+// d->frames samples that can be handed straight to a processing routine.
+static inline uint16_t *bufdesc_channel(const BufDesc *d, uint16_t ch)
+{
+    return d->data + (uint32_t)ch * d->chStride;
+}
+
+static inline uint16_t bufdesc_sample(const BufDesc *d, uint16_t ch,
+                                      uint16_t frame)
+{
+    return d->data[(uint32_t)ch * d->chStride + (uint32_t)frame * d->frStride];
+}
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Split storage (count * channels * frames words) into count blocks with the
+// given layout; desc must have room for count descriptors. All blocks start
+// free.
+void buf_pool_init(BufPool *pool, BufDesc *desc, uint16_t *storage,
+                   uint16_t count, uint16_t channels, uint16_t frames,
+                   uint16_t chStride, uint16_t frStride);
+
+// Producer: take a free block to fill, or NULL if none is free.
+BufDesc *buf_pool_startFill(BufPool *pool);
+
+// Producer: hand over the completed block and return the next one to fill.
+// If no block is free, filled itself is returned and the block is dropped.
+BufDesc *buf_pool_rotate(BufPool *pool, BufDesc *filled);
+
+// Consumer: oldest completed block (now owned by the caller), or NULL.
+BufDesc *buf_pool_acquire(BufPool *pool);
+
+// Consumer: give an owned block back to the pool.
+void buf_pool_release(BufPool *pool, BufDesc *d);
+
+// Blocks completed and not yet acquired.
+uint16_t buf_pool_readyCount(const BufPool *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BUF_POOL_H
@@ -0,0 +1,146 @@
+//#############################################################################
+// File: dma_chain.c
+// Chapter: DMA
+// Code description: walks a DMAChain_Descriptor list from the channel's
+// end-of-transfer interrupt. Address registers are written to their shadow
+// copies (latched at the start of the next transfer); sizes and steps are
+// written directly, which is safe because the channel is idle between the
+// end of a transfer and the next trigger. The reload therefore has to finish
+// within one trigger period - lateReloads counts the times it did not.
+//#############################################################################
+
+#include "driverlib.h"
+#include "device.h"
+#include "dma_chain.h"
+
+//---------------------------------------------------------------------------
+// Write one descriptor into the channel registers
+//---------------------------------------------------------------------------
+// Open-coded instead of DMA_configAddresses/Burst/Transfer/Wrap(): one
+// EALLOW window and no argument checks keep the ISR path short and of
+// constant length.
+static inline void loadDescriptor(uint32_t base, const DMAChain_Descriptor *d)
+{
+    EALLOW;
+
+    HWREG(base + DMA_O_SRC_BEG_ADDR_SHADOW) = (uint32_t)d->src;
+    HWREG(base + DMA_O_SRC_ADDR_SHADOW)     = (uint32_t)d->src;
+    HWREG(base + DMA_O_DST_BEG_ADDR_SHADOW) = (uint32_t)d->dst;
+    HWREG(base + DMA_O_DST_ADDR_SHADOW)     = (uint32_t)d->dst;
+
+    HWREGH(base + DMA_O_BURST_SIZE)        = d->burstSize - 1U;
+    HWREGH(base + DMA_O_SRC_BURST_STEP)    = d->srcBurstStep;
+    HWREGH(base + DMA_O_DST_BURST_STEP)    = d->dstBurstStep;
+
+    HWREGH(base + DMA_O_TRANSFER_SIZE)     = (uint16_t)(d->transferSize - 1U);
+    HWREGH(base + DMA_O_SRC_TRANSFER_STEP) = d->srcTransferStep;
+    HWREGH(base + DMA_O_DST_TRANSFER_STEP) = d->dstTransferStep;
+
+    HWREGH(base + DMA_O_SRC_WRAP_SIZE)     = (uint16_t)(d->srcWrapSize - 1U);
+    HWREGH(base + DMA_O_SRC_WRAP_STEP)     = d->srcWrapStep;
+    HWREGH(base + DMA_O_DST_WRAP_SIZE)     = (uint16_t)(d->dstWrapSize - 1U);
+    HWREGH(base + DMA_O_DST_WRAP_STEP)     = d->dstWrapStep;
+
+    EDIS;
+}
+
+//---------------------------------------------------------------------------
+// Bind a list to a channel
+//---------------------------------------------------------------------------
+void dma_chain_init(DMAChain *chain, uint32_t dmaBase, DMA_Trigger trigger,
+                    uint32_t modeConfig, const DMAChain_Descriptor *list,
+                    uint16_t count, bool loop)
+{
+    chain->base   = dmaBase;
+    chain->list   = list;
+    chain->count  = count;
+    chain->active = 0;
+    chain->loop   = loop;
+    chain->onDone = NULL;
+    chain->onDoneArg = NULL;
+
+    chain->transfersDone   = 0;
+    chain->reloadCycles    = 0;
+    chain->reloadCyclesMax = 0;
+    chain->lateReloads     = 0;
+
+    // Reload timestamps: free-running down counter at SYSCLK.
+    CPUTimer_stopTimer(DMA_CHAIN_TIMESTAMP_BASE);
+    CPUTimer_setPeriod(DMA_CHAIN_TIMESTAMP_BASE, 0xFFFFFFFF);
+    CPUTimer_setPreScaler(DMA_CHAIN_TIMESTAMP_BASE, 0);
+    CPUTimer_reloadTimerCounter(DMA_CHAIN_TIMESTAMP_BASE);
+    CPUTimer_startTimer(DMA_CHAIN_TIMESTAMP_BASE);
+
+    // Shadow registers are copied to the active ones when the channel starts.
+    loadDescriptor(dmaBase, &list[0]);
+
+    DMA_configMode(dmaBase, trigger, modeConfig | DMA_CFG_CONTINUOUS_ENABLE);
+    DMA_setInterruptMode(dmaBase, DMA_INT_AT_END);
+    DMA_enableTrigger(dmaBase);
+    DMA_enableInterrupt(dmaBase);
+}
+
+void dma_chain_setDoneCallback(DMAChain *chain, DMAChain_Callback cb,
+                               void *arg)
+{
+    chain->onDoneArg = arg;
+    chain->onDone    = cb;
+}
+
+void dma_chain_start(DMAChain *chain)
+{
+    DMA_startChannel(chain->base);
+}
+
+void dma_chain_stop(DMAChain *chain)
+{
+    DMA_stopChannel(chain->base);
+}
+
+//---------------------------------------------------------------------------
+// End-of-transfer handler (interrupt context)
+//---------------------------------------------------------------------------
+uint16_t dma_chain_onTransferEnd(DMAChain *chain)
+{
+    uint32_t t0 = CPUTimer_getTimerCount(DMA_CHAIN_TIMESTAMP_BASE);
+    uint32_t dt;
+    uint16_t done = chain->active;
+    uint16_t next = done + 1U;
+
+    if (next >= chain->count)
+    {
+        if (!chain->loop)
+        {
+            // Continuous mode would re-run the last descriptor on the next
+            // trigger; halt before that happens.
+            DMA_stopChannel(chain->base);
+            chain->transfersDone++;
+            if (chain->onDone != NULL)
+            {
+                chain->onDone(chain->onDoneArg);
+            }
+            return done;
+        }
+        next = 0;
+    }
+
+    loadDescriptor(chain->base, &chain->list[next]);
+    chain->active = next;
+
+    // TRANSFERSTS set again means a trigger already started the next transfer
+    // on the previous descriptor's sizes and steps.
+    if (DMA_getTransferStatusFlag(chain->base))
+    {
+        chain->lateReloads++;
+    }
+
+    dt = t0 - CPUTimer_getTimerCount(DMA_CHAIN_TIMESTAMP_BASE);
+    chain->reloadCycles = dt;
+    if (dt > chain->reloadCyclesMax)
+    {
+        chain->reloadCyclesMax = dt;
+    }
+
+    chain->transfersDone++;
+    return done;
+}
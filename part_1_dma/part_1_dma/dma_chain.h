@@ -0,0 +1,98 @@
+//#############################################################################
+// File: dma_chain.h
+// Chapter: DMA
+// Code description: descriptor lists for one DMA channel. The F2837xD DMA
+// cannot fetch descriptors by itself, so the channel interrupts at the end of
+// every transfer and dma_chain_onTransferEnd() writes the next descriptor
+// into the channel registers before the next trigger arrives. The time this
+// takes is measured on every reload.
+//#############################################################################
+
+#ifndef DMA_CHAIN_H
+#define DMA_CHAIN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dma.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// Free-running timer used to time the reloads (counts SYSCLK cycles down).
+#define DMA_CHAIN_TIMESTAMP_BASE    CPUTIMER2_BASE
+
+// Wrap size that never wraps (the register holds size - 1 = 0xFFFF).
+#define DMA_CHAIN_NO_WRAP           0x10000UL
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// One transfer of the chain. Sizes are counts (>= 1), steps are in 16-bit
+// words, exactly as for DMA_configBurst/Transfer/Wrap().
+typedef struct
+{
+    const void *src;
+    void       *dst;
+    uint16_t    burstSize;          // Words per burst (1..32)
+    int16_t     srcBurstStep;
+    int16_t     dstBurstStep;
+    uint32_t    transferSize;       // Bursts per transfer (1..65536)
+    int16_t     srcTransferStep;
+    int16_t     dstTransferStep;
+    uint32_t    srcWrapSize;        // Bursts before wrapping, or DMA_CHAIN_NO_WRAP
+    int16_t     srcWrapStep;
+    uint32_t    dstWrapSize;
+    int16_t     dstWrapStep;
+} DMAChain_Descriptor;
+
+// Called from interrupt context when the last descriptor of a non-looping
+// list has completed.
+typedef void (*DMAChain_Callback)(void *arg);
+
+typedef struct
+{
+    uint32_t base;                      // DMA channel
+    const DMAChain_Descriptor *list;
+    uint16_t count;                     // Descriptors in list
+    uint16_t active;                    // Descriptor being transferred now
+    bool     loop;                      // Restart at list[0] after the last
+    DMAChain_Callback onDone;
+    void    *onDoneArg;
+
+    // Statistics (read-only for the application)
+    uint32_t transfersDone;             // Completed descriptors
+    uint32_t reloadCycles;              // Last reload time, SYSCLK cycles
+    uint32_t reloadCyclesMax;           // Worst reload time
+    uint32_t lateReloads;               // Next transfer began before reload ended
+} DMAChain;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Bind a descriptor list to a channel and load list[0]. modeConfig is passed
+// to DMA_configMode() with DMA_CFG_CONTINUOUS_ENABLE added, so the channel
+// keeps running between descriptors. Call after DMA_initController().
+void dma_chain_init(DMAChain *chain, uint32_t dmaBase, DMA_Trigger trigger,
+                    uint32_t modeConfig, const DMAChain_Descriptor *list,
+                    uint16_t count, bool loop);
+
+void dma_chain_setDoneCallback(DMAChain *chain, DMAChain_Callback cb,
+                               void *arg);
+
+void dma_chain_start(DMAChain *chain);
+void dma_chain_stop(DMAChain *chain);
+
+// Call first thing from the channel's end-of-transfer ISR. Returns the index
+// of the descriptor that has just completed.
+uint16_t dma_chain_onTransferEnd(DMAChain *chain);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMA_CHAIN_H
@@ -0,0 +1,378 @@
+//#############################################################################
+// File: dma_copy.c
+// Chapter: DMA
+// Code description: software-triggered DMA copies between GS RAM blocks.
+// A request is split into whole DMA_COPY_BURST-word bursts moved by the DMA
+// and a short tail (< 1 burst) copied by the CPU just before the DMA starts.
+//#############################################################################
+
+#include "driverlib.h"
+#include "device.h"
+#include "dma_copy.h"
+#include <string.h>
+
+//---------------------------------------------------------------------------
+// DMA data sections
+//---------------------------------------------------------------------------
+// The memset source word and the benchmark buffers must be DMA-reachable;
+// .bss lives in LS RAM, which the DMA cannot see.
+#pragma DATA_SECTION(fillWord, "ramgs2");
+#ifdef DMA_COPY_RUN_BENCHMARK
+#pragma DATA_SECTION(benchSrc, "ramgs2");
+#pragma DATA_SECTION(benchDst, "ramgs2");
+
+#define BENCH_MAX_WORDS     1024U
+#endif
+
+//---------------------------------------------------------------------------
+// Globals
+//---------------------------------------------------------------------------
+static uint16_t fillWord;
+
+#ifdef DMA_COPY_RUN_BENCHMARK
+DMACopy_Bench dmaCopyBench;
+
+static uint16_t benchSrc[BENCH_MAX_WORDS];
+static uint16_t benchDst[BENCH_MAX_WORDS];
+#endif
+
+static uint32_t copyBase;
+static volatile bool copyBusy = false;
+static DMACopy_Callback copyCallback;
+static void *copyCallbackArg;
+
+//---------------------------------------------------------------------------
+// Program the channel for one request and fire it
+//  - burst/burstStep: words per burst and source step inside a burst
+//  - transferStep: source step after the last word of a burst
+//  The destination is always contiguous.
+//---------------------------------------------------------------------------
+static void startTransfer(void *dst, const void *src, uint16_t burst,
+                          int16_t srcBurstStep, int16_t srcTransferStep,
+                          uint32_t nBursts)
+{
+    copyBusy = true;
+
+    DMA_configAddresses(copyBase, dst, src);
+    DMA_configBurst(copyBase, burst, srcBurstStep, 1);
+    DMA_configTransfer(copyBase, nBursts, srcTransferStep, 1);
+
+    DMA_startChannel(copyBase);
+    DMA_forceTrigger(copyBase);
+}
+
+//---------------------------------------------------------------------------
+// Retire the running request and run its callback. Called from the ISR and
+// from the polling waits, whichever sees the end first.
+//---------------------------------------------------------------------------
+static void completeTransfer(void)
+{
+    DMACopy_Callback cb;
+    void *arg;
+    bool wasDisabled = Interrupt_disableGlobal();
+
+    if (!copyBusy)
+    {
+        if (!wasDisabled)
+        {
+            Interrupt_enableGlobal();
+        }
+        return;
+    }
+
+    cb  = copyCallback;
+    arg = copyCallbackArg;
+    copyCallback = NULL;
+    copyBusy = false;
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+
+    if (cb != NULL)
+    {
+        cb(arg);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Busy-wait for the running request, without relying on the interrupt
+//---------------------------------------------------------------------------
+static void waitTransfer(void)
+{
+    // RUNSTS drops when a one-shot, non-continuous transfer completes.
+    while (DMA_getRunStatusFlag(copyBase))
+    {
+    }
+    completeTransfer();
+}
+
+//---------------------------------------------------------------------------
+// Source span of a strided gather, as a start address and a length
+//---------------------------------------------------------------------------
+static bool isGatherReachable(const void *src, int16_t srcStride,
+                              uint32_t nWords)
+{
+    uint32_t step = (uint32_t)((srcStride < 0) ? -srcStride : srcStride);
+    uint32_t span = (nWords - 1U) * step + 1U;
+    const uint16_t *start = (const uint16_t *)src;
+
+    // A negative stride walks down from src.
+    if (srcStride < 0)
+    {
+        start = start - (span - 1U);
+    }
+    return dma_copy_isReachable(start, span);
+}
+
+//---------------------------------------------------------------------------
+// Configure the copy channel
+//---------------------------------------------------------------------------
+void dma_copy_init(uint32_t dmaBase)
+{
+    copyBase = dmaBase;
+    copyBusy = false;
+    copyCallback = NULL;
+
+    // No wrapping: wrap size is larger than any transfer.
+    DMA_configWrap(dmaBase, 0x10000UL, 0, 0x10000UL, 0);
+
+    //  - Trigger source: software (DMA_forceTrigger)
+    //  - ONESHOT enabled: one trigger moves every burst of the transfer
+    //  - CONTINUOUS disabled: the channel stops (RUNSTS = 0) when done
+    DMA_configMode(dmaBase,
+                   DMA_TRIGGER_SOFTWARE,
+                   DMA_CFG_ONESHOT_ENABLE |
+                   DMA_CFG_CONTINUOUS_DISABLE |
+                   DMA_CFG_SIZE_16BIT);
+
+    DMA_setInterruptMode(dmaBase, DMA_INT_AT_END);
+    DMA_enableTrigger(dmaBase);
+    DMA_enableInterrupt(dmaBase);
+}
+
+//---------------------------------------------------------------------------
+// Synchronous API
+//---------------------------------------------------------------------------
+void dma_memcpy(void *dst, const void *src, uint32_t nWords)
+{
+    if ((nWords < DMA_COPY_MIN_WORDS) || (nWords > DMA_COPY_MAX_WORDS) ||
+        copyBusy ||
+        !dma_copy_isReachable(dst, nWords) ||
+        !dma_copy_isReachable(src, nWords))
+    {
+        memcpy(dst, src, nWords);   // char is 16 bits: nWords == sizeof
+        return;
+    }
+
+    (void)dma_memcpy_async(dst, src, nWords, NULL, NULL);
+    waitTransfer();
+}
+
+void dma_memset(void *dst, uint16_t value, uint32_t nWords)
+{
+    if ((nWords < DMA_COPY_MIN_WORDS) || (nWords > DMA_COPY_MAX_WORDS) ||
+        copyBusy ||
+        !dma_copy_isReachable(dst, nWords))
+    {
+        memset(dst, value, nWords); // fills 16-bit chars, i.e. words
+        return;
+    }
+
+    (void)dma_memset_async(dst, value, nWords, NULL, NULL);
+    waitTransfer();
+}
+
+void dma_gather(void *dst, const void *src, int16_t srcStride,
+                uint32_t nWords)
+{
+    uint32_t i;
+
+    if ((nWords < DMA_COPY_MIN_WORDS) || (nWords > 65536UL) || copyBusy ||
+        !dma_copy_isReachable(dst, nWords) ||
+        !isGatherReachable(src, srcStride, nWords))
+    {
+        for (i = 0; i < nWords; i++)
+        {
+            ((uint16_t *)dst)[i] =
+                ((const uint16_t *)src)[(int32_t)i * srcStride];
+        }
+        return;
+    }
+
+    (void)dma_gather_async(dst, src, srcStride, nWords, NULL, NULL);
+    waitTransfer();
+}
+
+//---------------------------------------------------------------------------
+// Asynchronous API
+//---------------------------------------------------------------------------
+bool dma_memcpy_async(void *dst, const void *src, uint32_t nWords,
+                      DMACopy_Callback cb, void *arg)
+{
+    uint32_t bursts = nWords / DMA_COPY_BURST;
+    uint32_t bulk   = bursts * DMA_COPY_BURST;
+
+    if (copyBusy || (nWords > DMA_COPY_MAX_WORDS) ||
+        !dma_copy_isReachable(dst, nWords) ||
+        !dma_copy_isReachable(src, nWords))
+    {
+        return false;
+    }
+
+    // Tail first, so the completion callback sees the whole request.
+    memcpy((uint16_t *)dst + bulk, (const uint16_t *)src + bulk,
+           nWords - bulk);
+
+    if (bursts != 0U)
+    {
+        copyCallback = cb;
+        copyCallbackArg = arg;
+        startTransfer(dst, src, DMA_COPY_BURST, 1, 1, bursts);
+    }
+    else if (cb != NULL)
+    {
+        cb(arg);    // Nothing for the DMA to do: complete inline
+    }
+    return true;
+}
+
+bool dma_memset_async(void *dst, uint16_t value, uint32_t nWords,
+                      DMACopy_Callback cb, void *arg)
+{
+    uint32_t bursts = nWords / DMA_COPY_BURST;
+    uint32_t bulk   = bursts * DMA_COPY_BURST;
+
+    if (copyBusy || (nWords > DMA_COPY_MAX_WORDS) ||
+        !dma_copy_isReachable(dst, nWords))
+    {
+        return false;
+    }
+
+    memset((uint16_t *)dst + bulk, value, nWords - bulk);
+
+    if (bursts != 0U)
+    {
+        copyCallback = cb;
+        copyCallbackArg = arg;
+        fillWord = value;
+
+        // Source never moves: burst and transfer steps are 0.
+        startTransfer(dst, &fillWord, DMA_COPY_BURST, 0, 0, bursts);
+    }
+    else if (cb != NULL)
+    {
+        cb(arg);
+    }
+    return true;
+}
+
+bool dma_gather_async(void *dst, const void *src, int16_t srcStride,
+                      uint32_t nWords, DMACopy_Callback cb, void *arg)
+{
+    if (copyBusy || (nWords == 0U) || (nWords > 65536UL) ||
+        !dma_copy_isReachable(dst, nWords) ||
+        !isGatherReachable(src, srcStride, nWords))
+    {
+        return false;
+    }
+
+    copyCallback = cb;
+    copyCallbackArg = arg;
+
+    // One word per burst; the stride is applied between bursts.
+    startTransfer(dst, src, 1, 0, srcStride, nWords);
+    return true;
+}
+
+bool dma_copy_isBusy(void)
+{
+    return copyBusy;
+}
+
+void dma_copy_wait(void)
+{
+    // Polls the channel, so this also works with the PIE vector disabled or
+    // INTM set; the callback runs here if the ISR has not taken it yet.
+    waitTransfer();
+}
+
+//---------------------------------------------------------------------------
+// Copy channel ISR (end of transfer)
+//---------------------------------------------------------------------------
+__interrupt void dma_copy_isr(void)
+{
+    // A flag left pending by a polled (synchronous) request can be taken
+    // once the vector is enabled; completeTransfer() ignores it then.
+    if (!DMA_getRunStatusFlag(copyBase))
+    {
+        completeTransfer();
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);   // Clear PIE group 7 flag
+}
+
+#ifdef DMA_COPY_RUN_BENCHMARK
+//---------------------------------------------------------------------------
+// CPU vs DMA copy benchmark
+//---------------------------------------------------------------------------
+// Whole request by the DMA: below one DMA_COPY_BURST, dma_memcpy_async()
+// would copy everything in its CPU tail, so such sizes go as one short burst.
+static void benchDmaCopy(uint16_t words)
+{
+    if (words < DMA_COPY_BURST)
+    {
+        startTransfer(benchDst, benchSrc, words, 1, 1, 1);
+    }
+    else
+    {
+        (void)dma_memcpy_async(benchDst, benchSrc, words, NULL, NULL);
+    }
+    waitTransfer();
+}
+
+void dma_copy_benchmark(void)
+{
+    uint16_t p;
+    uint16_t words = 8;
+    uint32_t t0;
+    uint32_t i;
+
+    for (i = 0; i < BENCH_MAX_WORDS; i++)
+    {
+        benchSrc[i] = (uint16_t)i;
+    }
+
+    // CPU Timer 1 as a free-running down counter at SYSCLK.
+    CPUTimer_stopTimer(CPUTIMER1_BASE);
+    CPUTimer_setPeriod(CPUTIMER1_BASE, 0xFFFFFFFF);
+    CPUTimer_setPreScaler(CPUTIMER1_BASE, 0);
+    CPUTimer_reloadTimerCounter(CPUTIMER1_BASE);
+    CPUTimer_startTimer(CPUTIMER1_BASE);
+
+    dmaCopyBench.crossoverWords = 0;
+
+    for (p = 0; p < DMA_COPY_BENCH_POINTS; p++, words <<= 1)
+    {
+        dmaCopyBench.words[p] = words;
+
+        t0 = CPUTimer_getTimerCount(CPUTIMER1_BASE);
+        memcpy(benchDst, benchSrc, words);
+        dmaCopyBench.cpuCycles[p] = t0 - CPUTimer_getTimerCount(CPUTIMER1_BASE);
+
+        // DMA at every size, regardless of DMA_COPY_MIN_WORDS
+        t0 = CPUTimer_getTimerCount(CPUTIMER1_BASE);
+        benchDmaCopy(words);
+        dmaCopyBench.dmaCycles[p] = t0 - CPUTimer_getTimerCount(CPUTIMER1_BASE);
+
+        if ((dmaCopyBench.crossoverWords == 0U) &&
+            (dmaCopyBench.dmaCycles[p] < dmaCopyBench.cpuCycles[p]))
+        {
+            dmaCopyBench.crossoverWords = words;
+        }
+    }
+
+    CPUTimer_stopTimer(CPUTIMER1_BASE);
+}
+#endif // DMA_COPY_RUN_BENCHMARK
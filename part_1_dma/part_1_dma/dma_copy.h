@@ -0,0 +1,119 @@
+//#############################################################################
+// File: dma_copy.h
+// Chapter: DMA
+// Code description: DMA-accelerated memcpy / memset / strided gather for
+// memory the DMA can reach (GS RAM). One channel is reserved for copies and
+// triggered by software (DMA_forceTrigger) in one-shot mode, so a whole
+// request runs from a single trigger.
+// Sizes and strides are in 16-bit words, as everywhere on the C28x.
+//#############################################################################
+
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// Words moved per burst. 32 is the hardware maximum; it does not delay a
+// capture on CH1 in high priority mode, which suspends the copy after the
+// current word.
+#define DMA_COPY_BURST          32U
+
+// Below this size the synchronous calls copy with the CPU instead: the
+// channel setup costs more than it saves. Measured with
+// dma_copy_benchmark(), see dmaCopyBench.crossoverWords.
+#define DMA_COPY_MIN_WORDS      64U
+
+// Largest request the channel can take in one go (65536 bursts).
+#define DMA_COPY_MAX_WORDS      (65536UL * DMA_COPY_BURST)
+
+// GS RAM window, the only data RAM the DMA can access.
+#define DMA_COPY_GSRAM_START    0x00C000UL
+#define DMA_COPY_GSRAM_END      0x01C000UL
+
+// Number of sizes measured by dma_copy_benchmark() (8 .. 1024 words).
+#define DMA_COPY_BENCH_POINTS   8U
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// Completion callback, called from dma_copy_isr() (interrupt context).
+typedef void (*DMACopy_Callback)(void *arg);
+
+#ifdef DMA_COPY_RUN_BENCHMARK
+typedef struct
+{
+    uint16_t words[DMA_COPY_BENCH_POINTS];      // Request size (words)
+    uint32_t cpuCycles[DMA_COPY_BENCH_POINTS];  // memcpy() time
+    uint32_t dmaCycles[DMA_COPY_BENCH_POINTS];  // All-DMA copy time, incl. setup
+    uint16_t crossoverWords;                    // First size where DMA wins
+} DMACopy_Bench;
+
+extern DMACopy_Bench dmaCopyBench;
+#endif
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Configure dmaBase as the copy channel. Call after DMA_initController().
+// For the async forms also register dma_copy_isr() on the channel's PIE
+// vector (e.g. INT_DMA_CH6) and enable it.
+void dma_copy_init(uint32_t dmaBase);
+
+// True if [addr, addr + nWords) lies in DMA-reachable RAM. Addresses at or
+// above the window (flash, message RAM) must not reach the subtraction.
+static inline bool dma_copy_isReachable(const void *addr, uint32_t nWords)
+{
+    uint32_t start = (uint32_t)(uintptr_t)addr;
+
+    return (start >= DMA_COPY_GSRAM_START) &&
+           (start < DMA_COPY_GSRAM_END) &&
+           (nWords <= DMA_COPY_GSRAM_END - start);
+}
+
+// Synchronous forms: return once the data is in place. Small or unreachable
+// requests fall back to the CPU, so these can always be used.
+void dma_memcpy(void *dst, const void *src, uint32_t nWords);
+void dma_memset(void *dst, uint16_t value, uint32_t nWords);
+// dst[i] = src[i * srcStride], i = 0 .. nWords-1 (e.g. one channel out of
+// the interleaved rData frames with srcStride = 3).
+void dma_gather(void *dst, const void *src, int16_t srcStride,
+                uint32_t nWords);
+
+// Asynchronous forms: start the transfer and return. cb (may be NULL) runs
+// from dma_copy_isr() when the data is in place. Return false if the channel
+// is busy or a buffer is not DMA-reachable; nothing is started in that case.
+bool dma_memcpy_async(void *dst, const void *src, uint32_t nWords,
+                      DMACopy_Callback cb, void *arg);
+bool dma_memset_async(void *dst, uint16_t value, uint32_t nWords,
+                      DMACopy_Callback cb, void *arg);
+bool dma_gather_async(void *dst, const void *src, int16_t srcStride,
+                      uint32_t nWords, DMACopy_Callback cb, void *arg);
+
+bool dma_copy_isBusy(void);
+void dma_copy_wait(void);
+
+#ifdef DMA_COPY_RUN_BENCHMARK
+// Fill dmaCopyBench with CPU vs DMA copy times between two GS RAM buffers,
+// timed with CPU Timer 1 (reconfigured as a free-running counter). Every
+// size is moved by the DMA, the small ones as a single short burst. Built
+// only with the predefined symbol DMA_COPY_RUN_BENCHMARK (2K words of GS
+// RAM).
+void dma_copy_benchmark(void);
+#endif
+
+__interrupt void dma_copy_isr(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMA_COPY_H
@@ -0,0 +1,122 @@
+//#############################################################################
+// File: dma_health.c
+// Chapter: DMA
+// Code description: overrun, missed-trigger and consumer-lag accounting for a
+// continuously running DMA channel. The ISR side costs a flag read, a handful
+// of 32-bit adds and two compares per block, so it is left enabled in every
+// build.
+//#############################################################################
+
+#include "driverlib.h"
+#include "device.h"
+#include "dma_health.h"
+
+//---------------------------------------------------------------------------
+// Globals
+//---------------------------------------------------------------------------
+volatile DMAHealth_Counters dmaHealth;
+
+static uint32_t healthDmaBase;
+static const BufPool *healthPool;
+static uint32_t droppedAtReset;     // pool->dropped when last cleared
+static uint16_t lastTriggerCount;
+static bool     triggerCountValid = false;
+
+//---------------------------------------------------------------------------
+// Attach the counters to a DMA channel
+//---------------------------------------------------------------------------
+void dma_health_init(uint32_t dmaBase, const BufPool *pool,
+                     uint16_t triggersPerBlock)
+{
+    healthDmaBase = dmaBase;
+    healthPool    = pool;
+
+    dmaHealth.magic            = DMA_HEALTH_MAGIC;
+    dmaHealth.version          = DMA_HEALTH_VERSION;
+    dmaHealth.ringDepth        = pool->count;
+    dmaHealth.triggersPerBlock = triggersPerBlock;
+    dmaHealth.blocksProduced   = pool->produced;
+    dmaHealth.lag              = buf_pool_readyCount(pool);
+    dma_health_reset();
+
+    // Start from a clean overflow flag so stale errors from a previous run
+    // (e.g. a debugger restart) are not counted.
+    DMA_clearErrorFlag(dmaBase);
+    triggerCountValid = false;
+}
+
+//---------------------------------------------------------------------------
+// Producer side: called once per finished block from the DMA ISR
+//---------------------------------------------------------------------------
+void dma_health_onBlock(uint16_t triggerCount)
+{
+    // OVRFLG: a trigger arrived while the previous one was still pending, so
+    // one burst was dropped by the hardware.
+    if (DMA_getOverflowFlag(healthDmaBase))
+    {
+        dmaHealth.hwOverruns++;
+        DMA_clearErrorFlag(healthDmaBase);
+    }
+
+    // Every trigger should have produced exactly one burst. The first block
+    // only primes the reference, since the timer may have run before the
+    // channel was started.
+    if (triggerCountValid)
+    {
+        uint16_t ticks = triggerCount - lastTriggerCount; // modulo 2^16
+
+        if (ticks > dmaHealth.triggersPerBlock)
+        {
+            dmaHealth.missedTriggers += ticks - dmaHealth.triggersPerBlock;
+        }
+    }
+    lastTriggerCount  = triggerCount;
+    triggerCountValid = true;
+
+    // Hand-over accounting from the pool, which buf_pool_rotate() has just
+    // updated: a block refilled for lack of a free one is counted there
+    // (drop-newest). The ready count peaks right after a hand-over.
+    dmaHealth.blocksProduced   = healthPool->produced;
+    dmaHealth.consumerOverruns = healthPool->dropped - droppedAtReset;
+    dmaHealth.lag              = buf_pool_readyCount(healthPool);
+    if (dmaHealth.lag > dmaHealth.peakLag)
+    {
+        dmaHealth.peakLag = dmaHealth.lag;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Copy the counters out as one coherent set
+//---------------------------------------------------------------------------
+void dma_health_snapshot(DMAHealth_Counters *dst)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+
+    dmaHealth.lag = buf_pool_readyCount(healthPool);
+    *dst = *(const DMAHealth_Counters *)&dmaHealth;
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
+
+//---------------------------------------------------------------------------
+// Clear the event counters
+//---------------------------------------------------------------------------
+void dma_health_reset(void)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+
+    dmaHealth.hwOverruns       = 0;
+    dmaHealth.missedTriggers   = 0;
+    dmaHealth.consumerOverruns = 0;
+    droppedAtReset             = healthPool->dropped;
+    dmaHealth.lag              = buf_pool_readyCount(healthPool);
+    dmaHealth.peakLag          = dmaHealth.lag;
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
@@ -0,0 +1,78 @@
+//#############################################################################
+// File: dma_health.h
+// Chapter: DMA
+// Code description: always-on health counters for a DMA capture channel.
+// Only the DMA ISR writes them: hardware errors and missed triggers come
+// from the channel, block counts, drops and the consumer lag straight from
+// the capture buffer pool (buf_pool.h), so they can never disagree with it.
+// The whole block can be read from the Expressions window via the global
+// "dmaHealth", or copied out with dma_health_snapshot() for streaming.
+//#############################################################################
+
+#ifndef DMA_HEALTH_H
+#define DMA_HEALTH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "buf_pool.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// Marks the start of the block in a raw memory dump ("DH").
+#define DMA_HEALTH_MAGIC       0x4448U
+#define DMA_HEALTH_VERSION     2U
+
+//---------------------------------------------------------------------------
+// Health counter block
+//---------------------------------------------------------------------------
+// Every field is written by the DMA ISR (or with it masked), so reads of
+// single fields are always coherent on the C28x (aligned 32-bit accesses are
+// atomic).
+typedef struct
+{
+    uint16_t magic;             // DMA_HEALTH_MAGIC
+    uint16_t version;           // DMA_HEALTH_VERSION
+    uint16_t ringDepth;         // Number of buffers the DMA rotates through
+    uint16_t triggersPerBlock;  // Triggers (bursts) expected per block
+    uint32_t blocksProduced;    // Handed to the consumer (pool->produced)
+    uint32_t hwOverruns;        // Blocks during which OVRFLG was set
+    uint32_t missedTriggers;    // Timer ticks that produced no burst
+    uint32_t consumerOverruns;  // Blocks dropped: no free buffer left
+                                // (pool->dropped since reset)
+    uint16_t lag;               // Blocks ready, not yet acquired
+    uint16_t peakLag;           // Peak ready count since reset
+} DMAHealth_Counters;
+
+extern volatile DMAHealth_Counters dmaHealth;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Attach the counters to a DMA channel and the pool its blocks rotate
+// through (already initialised).
+void dma_health_init(uint32_t dmaBase, const BufPool *pool,
+                     uint16_t triggersPerBlock);
+
+// Call from the end-of-transfer ISR, after buf_pool_rotate(). triggerCount
+// is a free-running count of the triggers sent to the channel (e.g. the CPU
+// Timer 0 ISR counter).
+void dma_health_onBlock(uint16_t triggerCount);
+
+// Copy the counters with interrupts masked, for streaming over a link (lag
+// is refreshed from the pool first).
+void dma_health_snapshot(DMAHealth_Counters *dst);
+
+// Clear all event counters (configuration fields are kept).
+void dma_health_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DMA_HEALTH_H
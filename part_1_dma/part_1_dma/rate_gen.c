@@ -0,0 +1,115 @@
+//#############################################################################
+// File: rate_gen.c
+// Chapter: DMA / ADC
+// Code description: integer period computation and dithered reloads for a
+// CPU timer used as a sample-rate trigger. See rate_gen.h.
+//
+// The CPU timer counts PRD, PRD-1, ..., 0 and reloads, so one period lasts
+// PRD + 1 timer clocks: PRD is always written as (cycles - 1).
+//#############################################################################
+
+#include "rate_gen.h"
+
+//---------------------------------------------------------------------------
+// Derive cycles / fracNum and the achieved-rate report from the settings
+//---------------------------------------------------------------------------
+static void computePeriod(RateGen *gen)
+{
+    // Exact period in timer clocks: clkHz * rateDen / rateNum.
+    uint64_t scaled = (uint64_t)gen->clkHz * gen->rateDen;
+    uint64_t cycles = scaled / gen->rateNum;
+    uint32_t rem    = (uint32_t)(scaled % gen->rateNum);
+    int64_t  errNum;    // (achieved period - exact period) * rateNum
+
+    if (gen->dither)
+    {
+        // Long-term exact: the remainder is paid out by rate_gen_onTick().
+        gen->fracNum = rem;
+        errNum = 0;
+    }
+    else
+    {
+        // Nearest whole period.
+        if ((uint64_t)rem * 2U >= gen->rateNum)
+        {
+            cycles++;
+        }
+        gen->fracNum = 0;
+        errNum = (int64_t)(cycles * gen->rateNum) - (int64_t)scaled;
+    }
+
+    gen->cycles    = (uint32_t)cycles;
+    gen->prdCycles = (uint32_t)cycles;
+    gen->acc       = 0;
+
+    // A longer period means a lower rate: error = -dP / P.
+    gen->errorPpm   = (float32_t)(-1.0e6L * (long double)errNum /
+                                  ((long double)scaled + (long double)errNum));
+    gen->achievedHz = (float32_t)((long double)gen->rateNum /
+                                  (long double)gen->rateDen *
+                                  (1.0L + (long double)gen->errorPpm * 1.0e-6L));
+}
+
+//---------------------------------------------------------------------------
+// Program a CPU timer for the requested rate
+//---------------------------------------------------------------------------
+bool rate_gen_init(RateGen *gen, uint32_t timerBase, uint32_t clkHz,
+                   uint32_t rateNum, uint32_t rateDen, bool dither)
+{
+    uint64_t cycles;
+
+    if (rateNum == 0U)
+    {
+        return false;
+    }
+    rateDen = (rateDen == 0U) ? 1U : rateDen;
+
+    // PRD = cycles - 1 in 32 bits, with room for the extra dither or
+    // rounding cycle
+    cycles = ((uint64_t)clkHz * rateDen) / rateNum;
+    if ((cycles == 0U) || (cycles >= 0xFFFFFFFFULL))
+    {
+        return false;
+    }
+
+    gen->base    = timerBase;
+    gen->clkHz   = clkHz;
+    gen->rateNum = rateNum;
+    gen->rateDen = rateDen;
+    gen->dither  = dither;
+
+    computePeriod(gen);
+
+    CPUTimer_setPeriod(timerBase, gen->cycles - 1U);
+    CPUTimer_setPreScaler(timerBase, 0);
+    CPUTimer_stopTimer(timerBase);
+    CPUTimer_reloadTimerCounter(timerBase);
+
+    // When halted by debugger, timer stops after next decrement.
+    CPUTimer_setEmulationMode(timerBase,
+                              CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Follow a new timer clock
+//---------------------------------------------------------------------------
+void rate_gen_setClock(RateGen *gen, uint32_t clkHz)
+{
+    RateGen next = *gen;
+    bool wasDisabled;
+
+    // The 64-bit math runs with interrupts enabled; only the swap is atomic.
+    next.clkHz = clkHz;
+    computePeriod(&next);
+
+    wasDisabled = Interrupt_disableGlobal();
+
+    *gen = next;
+    HWREG(gen->base + CPUTIMER_O_PRD) = gen->cycles - 1U;
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
@@ -0,0 +1,89 @@
+//#############################################################################
+// File: rate_gen.h
+// Chapter: DMA / ADC
+// Code description: exact trigger-rate generator on a CPU timer. The period
+// is computed in integer arithmetic from the timer clock and the requested
+// rate (a fraction rateNum / rateDen Hz). When the clock is not an integer
+// multiple of the rate, the remainder is spread over successive periods
+// (dithered reloads, one extra cycle now and then) so that the long-term
+// rate is exact; each individual period is off by at most one cycle.
+//#############################################################################
+
+#ifndef RATE_GEN_H
+#define RATE_GEN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t base;          // CPU timer
+    uint32_t clkHz;         // Timer input clock (SYSCLK, prescaler 1)
+    uint32_t rateNum;       // Requested rate = rateNum / rateDen Hz
+    uint32_t rateDen;
+    bool     dither;
+
+    // Period = cycles + fracNum / rateNum cycles (exact)
+    uint32_t cycles;        // Whole timer cycles per period
+    uint32_t fracNum;       // Remainder, in units of 1/rateNum cycle
+    uint32_t acc;           // Dither accumulator, same units
+    uint32_t prdCycles;     // Period now in PRD (cycles or cycles + 1)
+
+    // Achieved rate
+    float32_t achievedHz;   // Long-term mean trigger rate
+    float32_t errorPpm;     // (achieved - requested) / requested * 1e6
+} RateGen;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Program timerBase for rateNum / rateDen Hz from a clkHz timer clock. The
+// timer is left stopped and reloaded, like configCPUTimer() used to do.
+// Without dither the period is rounded to the nearest cycle and the residual
+// error is reported in errorPpm. Returns false (timer untouched) for a zero
+// rate or a period not between 1 and 2^32 - 1 cycles.
+bool rate_gen_init(RateGen *gen, uint32_t timerBase, uint32_t clkHz,
+                   uint32_t rateNum, uint32_t rateDen, bool dither);
+
+// Recompute the periods for a new (e.g. measured) timer clock, keeping the
+// requested rate. Safe to call while the timer runs.
+void rate_gen_setClock(RateGen *gen, uint32_t clkHz);
+
+// Call once per period from the timer ISR when dithering. Costs one 32-bit
+// add and two compares, plus a PRD write when the period length changes.
+static inline void rate_gen_onTick(RateGen *gen)
+{
+    uint32_t cycles = gen->cycles;
+
+    if (gen->fracNum == 0U)
+    {
+        return;
+    }
+
+    gen->acc += gen->fracNum;
+    if (gen->acc >= gen->rateNum)
+    {
+        gen->acc -= gen->rateNum;
+        cycles++;
+    }
+
+    // PRD takes effect at the next reload (the current one has happened).
+    if (cycles != gen->prdCycles)
+    {
+        HWREG(gen->base + CPUTIMER_O_PRD) = cycles - 1U;
+        gen->prdCycles = cycles;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RATE_GEN_H
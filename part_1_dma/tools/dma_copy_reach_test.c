@@ -0,0 +1,52 @@
+//#############################################################################
+// File: dma_copy_reach_test.c
+// Chapter: DMA
+// Code description: host check of dma_copy_isReachable() (dma_copy.h): one
+// address below the GS RAM window, some inside it and some above it (flash,
+// message RAM), where the length check used to underflow.
+//
+// Build and run from part_1_dma:
+//   gcc -std=c99 -Wall -D__interrupt= -Ipart_1_dma tools/dma_copy_reach_test.c
+//       -o /tmp/dma_copy_reach_test && /tmp/dma_copy_reach_test
+//#############################################################################
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "dma_copy.h"
+
+static int failures = 0;
+
+static void check(uint32_t addr, uint32_t nWords, bool expected)
+{
+    bool got = dma_copy_isReachable((const void *)(uintptr_t)addr, nWords);
+
+    if (got != expected)
+    {
+        printf("FAIL 0x%06lx + %lu words: %d, expected %d\n",
+               (unsigned long)addr, (unsigned long)nWords, got, expected);
+        failures++;
+    }
+}
+
+int main(void)
+{
+    // Below the window (LS RAM)
+    check(0x00BFFFUL, 1, false);
+    check(0x00A000UL, 0x100, false);
+
+    // Inside
+    check(DMA_COPY_GSRAM_START, 1, true);
+    check(0x00D000UL, 0x100, true);
+    check(DMA_COPY_GSRAM_END - 0x100UL, 0x100, true);
+    check(DMA_COPY_GSRAM_END - 0x100UL, 0x101, false);   // Runs past the end
+
+    // At and above the end (message RAM, flash): no underflow
+    check(DMA_COPY_GSRAM_END, 1, false);
+    check(0x03FC00UL, 0x100, false);
+    check(0x080000UL, 1, false);
+    check(0x080000UL, 0, false);
+
+    printf("%s\n", (failures == 0) ? "PASS" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,290 @@
+//#############################################################################
+// File: adc_acq.c
+// Chapter: ADC
+// Code description: simultaneous multi-ADC acquisition. See adc_acq.h.
+//#############################################################################
+
+#include <math.h>
+#include "device.h"
+#include "adc_acq.h"
+
+//---------------------------------------------------------------------------
+// ADC lookup (ADC modules are 0x80 apart, result pages 0x20 apart)
+//---------------------------------------------------------------------------
+static const uint32_t adcIntNumber[ADC_ACQ_NUM_ADCS] =
+{
+    INT_ADCA1, INT_ADCB1, INT_ADCC1, INT_ADCD1
+};
+
+static inline uint16_t adcIndex(uint32_t adcBase)
+{
+    return (uint16_t)((adcBase - ADCA_BASE) >> 7);
+}
+
+static inline uint32_t adcBaseOf(uint16_t idx)
+{
+    return ADCA_BASE + ((uint32_t)idx << 7);
+}
+
+//---------------------------------------------------------------------------
+// Configure the converters and SOCs
+//---------------------------------------------------------------------------
+bool adc_acq_init(AdcAcq *acq, const AdcAcq_Input *inputs, uint16_t count,
+                  ADC_Trigger trigger, uint16_t acqps,
+                  ADC_ClkPrescale prescale, ADC_Resolution resolution,
+                  ADC_SignalMode signalMode, uint16_t osr,
+                  uint32_t sysclkHz)
+{
+    uint16_t i;
+    uint16_t a;
+    uint16_t slowest = 0;       // Unused ADCs count 0 SOCs, never win
+    uint32_t convHalfClk;
+    uint32_t socCycles;
+
+    if ((count == 0U) || (count > ADC_ACQ_MAX_CHANNELS) ||
+        (osr == 0U) || (osr > ADC_ACQ_MAX_OSR) ||
+        ((osr & (osr - 1U)) != 0U))
+    {
+        return false;
+    }
+
+    // Resolution-dependent window and stored-code format
+    acq->bits = (resolution == ADC_RESOLUTION_16BIT) ? 16U : 12U;
+    if (acqps < ((acq->bits == 16U) ? ADC_ACQ_MIN_ACQPS_16BIT
+                                    : ADC_ACQ_MIN_ACQPS_12BIT))
+    {
+        acqps = (acq->bits == 16U) ? ADC_ACQ_MIN_ACQPS_16BIT
+                                   : ADC_ACQ_MIN_ACQPS_12BIT;
+    }
+    acq->acqps = acqps;
+    acq->sumShift = 0;
+    while (((uint32_t)osr << (acq->bits - acq->sumShift)) > 0x10000UL)
+    {
+        acq->sumShift++;
+    }
+    acq->codeBits = acq->bits - acq->sumShift;
+    for (i = osr; i > 1U; i >>= 1)
+    {
+        acq->codeBits++;
+    }
+    acq->midCode = (signalMode == ADC_MODE_DIFFERENTIAL) ?
+        (uint16_t)(((uint32_t)osr << (acq->bits - 1U)) >> acq->sumShift) : 0U;
+
+    // Assign SOC numbers: each ADC counts its own SOCs from 0, osr per input
+    for (a = 0; a < ADC_ACQ_NUM_ADCS; a++)
+    {
+        acq->socsUsed[a] = 0;
+    }
+    for (i = 0; i < count; i++)
+    {
+        a = adcIndex(inputs[i].adcBase);
+        if (acq->socsUsed[a] + osr > ADC_ACQ_MAX_SOCS)
+        {
+            return false;
+        }
+        acq->soc[i]        = (ADC_SOCNumber)acq->socsUsed[a];
+        acq->resultBase[i] = ADCARESULT_BASE + ((uint32_t)a << 5);
+        acq->adcBase[i]    = inputs[i].adcBase;
+        acq->socsUsed[a]  += osr;
+    }
+    acq->count = count;
+    acq->osr   = osr;
+
+    // Power up the converters in use
+    for (a = 0; a < ADC_ACQ_NUM_ADCS; a++)
+    {
+        uint32_t base = adcBaseOf(a);
+
+        if (acq->socsUsed[a] == 0U)
+        {
+            continue;
+        }
+        ADC_setPrescaler(base, prescale);
+        ADC_setMode(base, resolution, signalMode);
+        ADC_setInterruptPulseMode(base, ADC_PULSE_END_OF_CONV);
+        ADC_setSOCPriority(base, ADC_PRI_ALL_ROUND_ROBIN);
+        ADC_enableConverter(base);
+
+        if (acq->socsUsed[a] > acq->socsUsed[slowest])
+        {
+            slowest = a;
+        }
+    }
+
+    // Delay for 1 ms to allow the ADCs to power up
+    DEVICE_DELAY_US(1000);
+
+    // Every SOC on the shared trigger
+    for (i = 0; i < count; i++)
+    {
+        uint16_t k;
+
+        for (k = 0; k < osr; k++)
+        {
+            ADC_setupSOC(inputs[i].adcBase, (ADC_SOCNumber)(acq->soc[i] + k),
+                         trigger, inputs[i].channel, acqps);
+        }
+    }
+
+    // One PPB per SOC where they suffice, trims start at zero
+    for (a = 0; a < ADC_ACQ_NUM_ADCS; a++)
+    {
+        uint16_t k;
+
+        if ((acq->socsUsed[a] == 0U) || (acq->socsUsed[a] > ADC_ACQ_NUM_PPBS))
+        {
+            continue;
+        }
+        for (k = 0; k < acq->socsUsed[a]; k++)
+        {
+            ADC_setupPPB(adcBaseOf(a), (ADC_PPBNumber)k, (ADC_SOCNumber)k);
+            ADC_setPPBCalibrationOffset(adcBaseOf(a), (ADC_PPBNumber)k, 0);
+        }
+    }
+
+    // End of vector: last SOC of the longest sequence
+    acq->intBase   = adcBaseOf(slowest);
+    acq->intNumber = adcIntNumber[slowest];
+    ADC_setInterruptSource(acq->intBase, ADC_INT_NUMBER1,
+                           (ADC_SOCNumber)(acq->socsUsed[slowest] - 1U));
+    ADC_enableInterrupt(acq->intBase, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(acq->intBase, ADC_INT_NUMBER1);
+
+    // Rate report: each SOC costs its S+H window plus the conversion, taken
+    // back to back (no credit for overlap, so the figure is conservative).
+    // ADCCLK = SYSCLK / ((prescale + 2) / 2).
+    convHalfClk = (resolution == ADC_RESOLUTION_16BIT) ?
+                  ADC_ACQ_CONV_HALFCLK_16BIT : ADC_ACQ_CONV_HALFCLK_12BIT;
+    socCycles = (uint32_t)acq->acqps + 1U +
+                (convHalfClk * ((uint32_t)prescale + 2U) + 3U) / 4U;
+    acq->vectorCycles = socCycles * acq->socsUsed[slowest];
+    acq->maxTriggerHz = (float32_t)sysclkHz / (float32_t)acq->vectorCycles;
+    acq->aggregateSps = acq->maxTriggerHz * (float32_t)count;
+
+    // ISR cost timestamps
+    acq->readCycles    = 0;
+    acq->readCyclesMax = 0;
+    adc_acq_startTimestamp(ADC_ACQ_TIMESTAMP_BASE);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Hardware offset trim through the PPBs
+//---------------------------------------------------------------------------
+bool adc_acq_setOffsetTrim(const AdcAcq *acq, uint16_t ch, int16_t offset)
+{
+    uint16_t k;
+
+    if ((ch >= acq->count) ||
+        (acq->socsUsed[adcIndex(acq->adcBase[ch])] > ADC_ACQ_NUM_PPBS))
+    {
+        return false;
+    }
+
+    // PPB k serves SOC k
+    for (k = 0; k < acq->osr; k++)
+    {
+        ADC_setPPBCalibrationOffset(acq->adcBase[ch],
+                                    (ADC_PPBNumber)(acq->soc[ch] + k), offset);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Store one time-aligned vector
+//---------------------------------------------------------------------------
+void adc_acq_readFrame(AdcAcq *acq, BufDesc *d, uint16_t frame)
+{
+    uint32_t t0 = CPUTimer_getTimerCount(ADC_ACQ_TIMESTAMP_BASE);
+    uint32_t dt;
+    uint16_t *dst = d->data + (uint32_t)frame * d->frStride;
+    uint16_t stride = d->chStride;
+    uint16_t osr = acq->osr;
+    uint16_t shift = acq->sumShift;
+    uint16_t mid = acq->midCode;
+    uint16_t i;
+
+    for (i = 0; i < acq->count; i++)
+    {
+        // The osr results of one input are adjacent result registers
+        const volatile uint16_t *res = (const volatile uint16_t *)
+            (acq->resultBase[i] + ADC_RESULTx_OFFSET_BASE + acq->soc[i]);
+        uint32_t sum = 0;
+        uint16_t k;
+
+        for (k = 0; k < osr; k++)
+        {
+            sum += res[k];
+        }
+
+        // Offset binary minus mid-scale is the two's complement code
+        *dst = (uint16_t)(sum >> shift) - mid;
+        dst += stride;
+    }
+
+    // The timer counts down
+    dt = t0 - CPUTimer_getTimerCount(ADC_ACQ_TIMESTAMP_BASE);
+    acq->readCycles = dt;
+    if (dt > acq->readCyclesMax)
+    {
+        acq->readCyclesMax = dt;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Noise / ENOB / cost report
+//---------------------------------------------------------------------------
+void adc_acq_report(const AdcAcq *acq, const BufDesc *d, uint16_t ch,
+                    AdcAcq_Report *r)
+{
+    float32_t first = 0.0f;
+    float32_t sum = 0.0f;
+    float32_t sumSq = 0.0f;
+    float32_t n = (float32_t)d->frames;
+    float32_t m;
+    float32_t var;
+    float32_t varFloor;
+    float32_t step;             // One stored LSB in single-conversion LSB
+    float32_t bits = (float32_t)acq->bits;
+    uint16_t f;
+
+    step = (float32_t)((uint32_t)1U << acq->sumShift) / (float32_t)acq->osr;
+
+    for (f = 0; f < d->frames; f++)
+    {
+        uint16_t code = bufdesc_sample(d, ch, f);
+        float32_t x = (acq->midCode != 0U) ? (float32_t)(int16_t)code
+                                           : (float32_t)code;
+
+        // Relative to the first sample, in stored codes: the sums stay small
+        // integers, so sumSq / n - m * m does not cancel at high DC codes
+        if (f == 0U)
+        {
+            first = x;
+        }
+        x -= first;
+        sum   += x;
+        sumSq += x * x;
+    }
+
+    m = sum / n;
+    r->mean = (first + m) * step;
+    var = (sumSq / n - m * m) * step * step;
+
+    // Never below the quantisation noise of the stored code, so a block with
+    // no spread reports the resolution limit, not infinity; flagged, as that
+    // limit (log2(osr) of "gain" with full oversampling) is not a measurement.
+    varFloor = step * step / 12.0f;
+    r->atFloor = (var < varFloor);
+    if (r->atFloor)
+    {
+        var = varFloor;
+    }
+    r->noiseLsb = sqrtf(var);
+
+    // An ideal converter has 1/sqrt(12) LSB of quantisation noise
+    r->enob = bits - logf(r->noiseLsb * 3.4641016f) * 1.4426950f;
+    r->enobGain = r->enob - bits;
+    r->cyclesPerOutput = (float32_t)acq->readCycles / (float32_t)acq->count;
+}
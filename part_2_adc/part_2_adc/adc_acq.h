@@ -0,0 +1,177 @@
+//#############################################################################
+// File: adc_acq.h
+// Chapter: ADC
+// Code description: multi-ADC acquisition engine. A table of inputs spread
+// over ADCA..ADCD is turned into SOCs that all share one trigger, so the four
+// converters sample in parallel: SOCn of every ADC starts on the same trigger
+// edge and each ADC walks its own SOCs in round-robin order. One interrupt,
+// from the ADC with the longest sequence, signals that a complete,
+// time-aligned channel vector is ready; adc_acq_readFrame() stores it in a
+// BufDesc block, interleaved or planar depending on the block's strides.
+//
+// Oversampling: with osr > 1 each input gets osr consecutive SOCs on the
+// same trigger. The ADC converts them back to back and adc_acq_readFrame()
+// stores their sum, a 16-bit code with log2(osr) extra LSBs (of which about
+// half are real resolution for white noise). In 16-bit mode the sum is
+// shifted back to 16 bits, i.e. the average is stored.
+//
+// Resolution and signal mode are per configuration: 12-bit single-ended
+// samples are stored unsigned, differential samples (16-bit mode, inputs
+// are the even pin of an ADCINx/ADCINx+1 pair) have the mid-scale code
+// removed and are stored as int16_t, 0 V differential reading as 0. When an ADC has no more than
+// four SOCs, each SOC gets its own post-processing block, so an offset trim
+// is subtracted in hardware before the summation.
+//
+// The engine also reports the trigger rate and aggregate sample rate the
+// configuration can sustain, and the ISR cost per output sample.
+//#############################################################################
+
+#ifndef ADC_ACQ_H
+#define ADC_ACQ_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+#include "buf_pool.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define ADC_ACQ_NUM_ADCS        4U      // ADCA..ADCD
+#define ADC_ACQ_MAX_SOCS        16U     // SOCs per ADC
+#define ADC_ACQ_MAX_CHANNELS    16U     // Inputs in one table
+#define ADC_ACQ_MAX_OSR         16U     // Power of two; 16 12-bit codes fit 16 bits
+
+// Shortest S+H window per resolution at SYSCLK = 200 MHz (datasheet: 75 ns
+// for 12-bit, 320 ns for 16-bit); smaller ACQPS values are raised to these.
+#define ADC_ACQ_MIN_ACQPS_12BIT     14U
+#define ADC_ACQ_MIN_ACQPS_16BIT     63U
+#define ADC_ACQ_NUM_PPBS        4U      // Post-processing blocks per ADC
+
+// Free-running timer for the ISR cost figures
+#define ADC_ACQ_TIMESTAMP_BASE  CPUTIMER1_BASE
+
+// Conversion time after the S+H window, in half ADCCLK cycles (TRM)
+#define ADC_ACQ_CONV_HALFCLK_12BIT  21U     // 10.5 ADCCLK
+#define ADC_ACQ_CONV_HALFCLK_16BIT  59U     // 29.5 ADCCLK
+
+//---------------------------------------------------------------------------
+// Timestamp timer
+//---------------------------------------------------------------------------
+// Make a CPU timer free-running (period 0xFFFFFFFF, no prescaler, counting
+// down) for timestamps: ADC_ACQ_TIMESTAMP_BASE, shared with adc_tune,
+// isr_prof, region_prof and clk_mon. A timer already running that way is
+// left alone so the other users' stamps stay valid; otherwise it is set up
+// and (re)started.
+static inline void adc_acq_startTimestamp(uint32_t base)
+{
+    if (((HWREGH(base + CPUTIMER_O_TCR) & CPUTIMER_TCR_TSS) == 0U) &&
+        (HWREG(base + CPUTIMER_O_PRD) == 0xFFFFFFFFUL) &&
+        ((HWREGH(base + CPUTIMER_O_TPR) & CPUTIMER_TPR_TDDR_M) == 0U) &&
+        ((HWREGH(base + CPUTIMER_O_TPRH) & CPUTIMER_TPRH_TDDRH_M) == 0U))
+    {
+        return;
+    }
+    CPUTimer_stopTimer(base);
+    CPUTimer_setPeriod(base, 0xFFFFFFFF);
+    CPUTimer_setPreScaler(base, 0);
+    CPUTimer_reloadTimerCounter(base);
+    CPUTimer_startTimer(base);
+}
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// One input of the acquisition table; the position in the table is the
+// channel number in the captured blocks.
+typedef struct
+{
+    uint32_t    adcBase;        // ADCA_BASE .. ADCD_BASE
+    ADC_Channel channel;        // ADC_CH_ADCINx (first pin of a pair in
+                                // differential mode)
+} AdcAcq_Input;
+
+typedef struct
+{
+    uint16_t count;                             // Channels per vector
+    uint16_t osr;                               // SOCs summed per sample
+    uint16_t bits;                              // 12 or 16
+    uint16_t sumShift;                          // Sum -> stored code
+    uint16_t codeBits;                          // Significant stored bits
+    uint16_t midCode;                           // Subtracted (differential)
+    uint16_t acqps;                             // S+H window actually used
+    uint32_t resultBase[ADC_ACQ_MAX_CHANNELS];  // Per channel
+    ADC_SOCNumber soc[ADC_ACQ_MAX_CHANNELS];    // First SOC, per channel
+    uint32_t adcBase[ADC_ACQ_MAX_CHANNELS];     // Per channel
+    uint16_t socsUsed[ADC_ACQ_NUM_ADCS];        // Per ADC
+
+    // End-of-vector interrupt (ADCINT1 of the slowest ADC, PIE group 1)
+    uint32_t intBase;
+    uint32_t intNumber;                         // INT_ADCx1
+
+    // Rate report
+    uint32_t vectorCycles;      // SYSCLK per trigger on the slowest ADC
+    float32_t maxTriggerHz;     // Fastest usable trigger
+    float32_t aggregateSps;     // maxTriggerHz * count (output samples)
+
+    // ISR cost of adc_acq_readFrame(), in SYSCLK
+    uint32_t readCycles;        // Last call
+    uint32_t readCyclesMax;
+} AdcAcq;
+
+// Noise / resolution report for one channel of a block taken on a DC input
+typedef struct
+{
+    float32_t mean;             // In single-conversion codes (signed when
+                                // differential)
+    float32_t noiseLsb;         // RMS noise, in single-conversion LSB
+    float32_t enob;             // ADC bits - log2(noiseLsb * sqrt(12))
+    float32_t enobGain;         // enob - ADC bits
+    bool      atFloor;          // Spread below the stored-code quantisation:
+                                // noise/enob are that limit, not measured
+    float32_t cyclesPerOutput;  // readCycles / count
+} AdcAcq_Report;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Power up every ADC used by the table, create its SOCs on the shared
+// trigger with round-robin priority, and set up the end-of-vector interrupt
+// (registering and enabling acq->intNumber is left to the caller). osr is
+// a power of two up to ADC_ACQ_MAX_OSR. acqps is raised to the minimum for
+// the resolution. Returns false for an empty table, an invalid osr, more
+// than ADC_ACQ_MAX_CHANNELS inputs or more than ADC_ACQ_MAX_SOCS on one ADC.
+bool adc_acq_init(AdcAcq *acq, const AdcAcq_Input *inputs, uint16_t count,
+                  ADC_Trigger trigger, uint16_t acqps,
+                  ADC_ClkPrescale prescale, ADC_Resolution resolution,
+                  ADC_SignalMode signalMode, uint16_t osr,
+                  uint32_t sysclkHz);
+
+// Hardware offset trim for one channel, in single-conversion codes
+// (-512..511), subtracted from each of its SOC results by the PPBs. Returns
+// false if its ADC has more SOCs than PPBs.
+bool adc_acq_setOffsetTrim(const AdcAcq *acq, uint16_t ch, int16_t offset);
+
+// Noise, ENOB and ISR cost for channel ch of block d (DC input expected).
+void adc_acq_report(const AdcAcq *acq, const BufDesc *d, uint16_t ch,
+                    AdcAcq_Report *r);
+
+// ISR: store the latest vector as frame "frame" of block d.
+void adc_acq_readFrame(AdcAcq *acq, BufDesc *d, uint16_t frame);
+
+// ISR: clear the end-of-vector interrupt flag.
+static inline void adc_acq_clearInterrupt(const AdcAcq *acq)
+{
+    ADC_clearInterruptStatus(acq->intBase, ADC_INT_NUMBER1);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_ACQ_H
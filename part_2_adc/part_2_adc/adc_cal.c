@@ -0,0 +1,192 @@
+//#############################################################################
+// File: adc_cal.c
+// Chapter: ADC
+// Code description: per-channel calibration tables. See adc_cal.h.
+//#############################################################################
+
+#include "adc_cal.h"
+#include "adc_scale.h"
+
+//---------------------------------------------------------------------------
+// Store one segment (reuses the Q16 rounding of adc_scale)
+//---------------------------------------------------------------------------
+static void setSegment(AdcCal *cal, uint16_t s, float32_t gain,
+                       float32_t offset)
+{
+    AdcScale q;
+
+    adc_scale_init(&q, gain, offset, cal->table.isSigned != 0U);
+    cal->table.gain[s]   = q.gain;
+    cal->table.offset[s] = q.offset;
+}
+
+//---------------------------------------------------------------------------
+// Piecewise-linear interpolant through the points, extended linearly
+//---------------------------------------------------------------------------
+static float32_t interpolate(const AdcCal *cal, float32_t x)
+{
+    uint16_t k = 1;
+
+    while ((k < cal->points - 1U) && (x > cal->code[k]))
+    {
+        k++;
+    }
+    return cal->ref[k - 1U] + (x - cal->code[k - 1U]) *
+           (cal->ref[k] - cal->ref[k - 1U]) /
+           (cal->code[k] - cal->code[k - 1U]);
+}
+
+//---------------------------------------------------------------------------
+// Set up / reset
+//---------------------------------------------------------------------------
+bool adc_cal_init(AdcCal *cal, uint16_t codeBits, uint16_t segments,
+                  bool isSigned, float32_t unitsPerCode, float32_t offsetUnits)
+{
+    uint16_t segBits = 0;
+
+    if ((segments == 0U) || (segments > ADC_CAL_MAX_SEGMENTS) ||
+        ((segments & (segments - 1U)) != 0U) || (codeBits > 16U))
+    {
+        return false;
+    }
+    while ((1U << segBits) < segments)
+    {
+        segBits++;
+    }
+    if (segBits > codeBits)
+    {
+        return false;
+    }
+
+    cal->segments         = segments;
+    cal->table.segShift   = codeBits - segBits;
+    cal->table.isSigned   = isSigned ? 1U : 0U;
+    cal->table.bias       = isSigned ? 0x8000U : 0U;
+    cal->idealGain        = unitsPerCode;
+    cal->idealOffset      = offsetUnits;
+    adc_cal_clear(cal);
+    return true;
+}
+
+void adc_cal_clear(AdcCal *cal)
+{
+    cal->points = 0;
+    adc_cal_build(cal);
+}
+
+//---------------------------------------------------------------------------
+// Measurement
+//---------------------------------------------------------------------------
+bool adc_cal_addPoint(AdcCal *cal, const BufDesc *d, uint16_t ch,
+                      float32_t refUnits)
+{
+    float32_t sum = 0.0f;
+    float32_t mean;
+    uint16_t f;
+    uint16_t k;
+
+    if ((cal->points >= ADC_CAL_MAX_POINTS) || (d->frames == 0U))
+    {
+        return false;
+    }
+
+    for (f = 0; f < d->frames; f++)
+    {
+        uint16_t c = bufdesc_sample(d, ch, f);
+
+        sum += (cal->table.isSigned != 0U) ? (float32_t)(int16_t)c
+                                           : (float32_t)c;
+    }
+    mean = sum / (float32_t)d->frames;
+
+    // Insertion keeps the points sorted by code
+    k = cal->points;
+    while ((k > 0U) && (cal->code[k - 1U] > mean))
+    {
+        cal->code[k] = cal->code[k - 1U];
+        cal->ref[k]  = cal->ref[k - 1U];
+        k--;
+    }
+    cal->code[k] = mean;
+    cal->ref[k]  = refUnits;
+    cal->points++;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Table build
+//---------------------------------------------------------------------------
+void adc_cal_build(AdcCal *cal)
+{
+    float32_t gain = cal->idealGain;
+    float32_t offset = cal->idealOffset;
+    float32_t span = (float32_t)(1UL << cal->table.segShift);
+    float32_t xBias = (cal->table.isSigned != 0U) ? 32768.0f : 0.0f;
+    uint16_t s;
+
+    if (cal->points == 1U)
+    {
+        // Offset only
+        offset = cal->ref[0] - gain * cal->code[0];
+    }
+    else if ((cal->points == 2U) && (cal->code[1] != cal->code[0]))
+    {
+        gain   = (cal->ref[1] - cal->ref[0]) / (cal->code[1] - cal->code[0]);
+        offset = cal->ref[0] - gain * cal->code[0];
+    }
+
+    for (s = 0; s < cal->segments; s++)
+    {
+        if (cal->points >= 3U)
+        {
+            // Chord of the interpolant across the segment
+            float32_t x0 = (float32_t)s * span - xBias;
+            float32_t x1 = x0 + span;
+            float32_t y0 = interpolate(cal, x0);
+            float32_t y1 = interpolate(cal, x1);
+
+            gain   = (y1 - y0) / span;
+            offset = y0 - gain * x0;
+        }
+        setSegment(cal, s, gain, offset);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Conversion pass: segment lookup + one multiply-add per sample
+//---------------------------------------------------------------------------
+void adc_cal_apply(const AdcCal_Table *t, const uint16_t *raw, uint16_t stride,
+                   int16_t *dst, uint16_t n)
+{
+    uint16_t shift = t->segShift;
+    uint16_t bias = t->bias;
+    uint16_t i;
+
+    // Stored codes never exceed the codeBits given at init, so the segment
+    // index stays inside the table.
+    if (t->isSigned != 0U)
+    {
+        for (i = 0; i < n; i++)
+        {
+            uint16_t c = *raw;
+            uint16_t s = (uint16_t)(c ^ bias) >> shift;
+
+            *dst = (int16_t)(((int32_t)(int16_t)c * t->gain[s] +
+                              t->offset[s]) >> 16);
+            raw += stride;
+            dst += stride;
+        }
+    }
+    else
+    {
+        for (i = 0; i < n; i++)
+        {
+            uint16_t c = *raw;
+            uint16_t s = c >> shift;
+
+            *dst = (int16_t)(((int32_t)c * t->gain[s] + t->offset[s]) >> 16);
+            raw += stride;
+            dst += stride;
+        }
+    }
+}
@@ -0,0 +1,97 @@
+//#############################################################################
+// File: adc_cal.h
+// Chapter: ADC
+// Code description: per-channel ADC calibration. The factory offset and INL
+// trims loaded by ADC_setMode() leave a per-board offset and gain error
+// (plus the input network's own error), and some residual non-linearity.
+// This module measures a channel against known reference inputs, one block
+// average per reference, and builds a compact table of Q16 gain/offset
+// pairs:
+//  - one reference:   offset correction, ideal gain
+//  - two references:  offset and gain
+//  - three or more:   piecewise-linear correction through all the points,
+//                     resampled onto 2^k equal code segments
+//
+// The batched conversion pass looks up the segment from the top bits of the
+// code and applies its pair, i.e. still one multiply-add per sample:
+//      out = (code * gain[seg] + offset[seg]) >> 16
+// Without INL correction all segments hold the same pair.
+//#############################################################################
+
+#ifndef ADC_CAL_H
+#define ADC_CAL_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+#include "buf_pool.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define ADC_CAL_MAX_SEGMENTS    16U     // Power of two
+#define ADC_CAL_MAX_POINTS      9U
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// What the conversion pass needs (2 * 16 + 3 words per channel)
+typedef struct
+{
+    uint16_t segShift;                      // Segment = (code ^ bias) >> shift
+    uint16_t bias;                          // 0x8000 for signed codes
+    uint16_t isSigned;
+    int32_t  gain[ADC_CAL_MAX_SEGMENTS];    // Output units per code, Q16
+    int32_t  offset[ADC_CAL_MAX_SEGMENTS];  // Q16, rounding included
+} AdcCal_Table;
+
+typedef struct
+{
+    AdcCal_Table table;
+    uint16_t  segments;
+
+    // Ideal conversion, used until (and where) nothing was measured
+    float32_t idealGain;
+    float32_t idealOffset;
+
+    // Reference points, sorted by code
+    uint16_t  points;
+    float32_t code[ADC_CAL_MAX_POINTS];     // Block average, stored codes
+    float32_t ref[ADC_CAL_MAX_POINTS];      // Reference, output units
+} AdcCal;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Start from the ideal conversion out = code * unitsPerCode + offsetUnits.
+// codeBits is the number of significant bits of the stored codes (e.g.
+// AdcAcq.codeBits), segments a power of two up to ADC_CAL_MAX_SEGMENTS.
+bool adc_cal_init(AdcCal *cal, uint16_t codeBits, uint16_t segments,
+                  bool isSigned, float32_t unitsPerCode, float32_t offsetUnits);
+
+// Drop the measured points and go back to the ideal table.
+void adc_cal_clear(AdcCal *cal);
+
+// Record channel ch of block d (taken with reference refUnits applied) as
+// one calibration point. Returns false when the point table is full.
+bool adc_cal_addPoint(AdcCal *cal, const BufDesc *d, uint16_t ch,
+                      float32_t refUnits);
+
+// Rebuild the table from the recorded points.
+void adc_cal_build(AdcCal *cal);
+
+// Conversion pass: n codes from raw[0], raw[stride], ... to dst with the
+// same stride.
+void adc_cal_apply(const AdcCal_Table *t, const uint16_t *raw, uint16_t stride,
+                   int16_t *dst, uint16_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_CAL_H
@@ -0,0 +1,255 @@
+//#############################################################################
+// File: adc_monitor.c
+// Chapter: ADC
+// Code description: PPB limit and zero-crossing events. See adc_monitor.h.
+//#############################################################################
+
+#include "adc_monitor.h"
+
+//---------------------------------------------------------------------------
+// Globals
+//---------------------------------------------------------------------------
+// One slot per PPB of every ADC
+static AdcMonitor_Channel monitor[ADC_ACQ_NUM_ADCS][ADC_ACQ_NUM_PPBS];
+
+static __interrupt void adcAEventISR(void);
+static __interrupt void adcBEventISR(void);
+static __interrupt void adcCEventISR(void);
+static __interrupt void adcDEventISR(void);
+
+static const uint32_t eventIntNumber[ADC_ACQ_NUM_ADCS] =
+{
+    INT_ADCA_EVT, INT_ADCB_EVT, INT_ADCC_EVT, INT_ADCD_EVT
+};
+
+static void (* const eventISR[ADC_ACQ_NUM_ADCS])(void) =
+{
+    adcAEventISR, adcBEventISR, adcCEventISR, adcDEventISR
+};
+
+//---------------------------------------------------------------------------
+// Channel -> ADC / PPB (adc_acq: ADCs 0x80 apart, PPB n serves SOC n)
+//---------------------------------------------------------------------------
+static inline uint16_t adcOf(const AdcAcq *acq, uint16_t ch)
+{
+    return (uint16_t)((acq->adcBase[ch] - ADCA_BASE) >> 7);
+}
+
+static inline AdcMonitor_Channel *slotOf(const AdcAcq *acq, uint16_t ch)
+{
+    if ((ch >= acq->count) || ((uint16_t)acq->soc[ch] >= ADC_ACQ_NUM_PPBS))
+    {
+        return (AdcMonitor_Channel *)0;
+    }
+    return &monitor[adcOf(acq, ch)][acq->soc[ch]];
+}
+
+//---------------------------------------------------------------------------
+// Arm a channel
+//---------------------------------------------------------------------------
+bool adc_monitor_watch(const AdcAcq *acq, uint16_t ch, int32_t reference,
+                       int32_t hiLimit, int32_t loLimit, uint16_t events,
+                       uint16_t latch)
+{
+    AdcMonitor_Channel *m = slotOf(acq, ch);
+    uint32_t base;
+    ADC_PPBNumber ppb;
+    int32_t rawRef;
+    uint16_t a;
+
+    if (m == 0)
+    {
+        return false;
+    }
+    base = acq->adcBase[ch];
+    ppb  = (ADC_PPBNumber)acq->soc[ch];
+    a    = adcOf(acq, ch);
+
+    // Quiet while reprogramming
+    ADC_disablePPBEventInterrupt(base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO |
+                                            ADC_EVT_ZERO);
+    ADC_disablePPBEvent(base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO |
+                                   ADC_EVT_ZERO);
+
+    m->armed       = 0;
+    m->ch          = ch;
+    m->events      = events & (ADC_EVT_TRIPHI | ADC_EVT_TRIPLO | ADC_EVT_ZERO);
+    m->latched     = latch & m->events;
+    m->tripHi      = 0;
+    m->tripLo      = 0;
+    m->zeroCross   = 0;
+    m->lastEvents  = 0;
+    m->lastResult  = 0;
+    m->lastDelay   = 0;
+    m->maxDelay    = 0;
+
+    // The PPB sees the raw (offset binary in differential mode) code, minus
+    // OFFREF; limits are relative to OFFREF.
+    rawRef = reference;
+    if (acq->midCode != 0U)
+    {
+        rawRef += (int32_t)1 << (acq->bits - 1U);
+    }
+    ADC_setupPPB(base, ppb, acq->soc[ch]);
+    ADC_setPPBReferenceOffset(base, ppb, (uint16_t)rawRef);
+    ADC_setPPBTripLimits(base, ppb, hiLimit - reference, loLimit - reference);
+
+    ADC_clearPPBEventStatus(base, ppb, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO |
+                                       ADC_EVT_ZERO);
+    ADC_enablePPBEvent(base, ppb, m->events);
+    m->armed = 1;
+    ADC_enablePPBEventInterrupt(base, ppb, m->events);
+
+    // The event vector is shared by the ADC's four PPBs
+    Interrupt_register(eventIntNumber[a], eventISR[a]);
+    Interrupt_enable(eventIntNumber[a]);
+    return true;
+}
+
+void adc_monitor_unwatch(const AdcAcq *acq, uint16_t ch)
+{
+    AdcMonitor_Channel *m = slotOf(acq, ch);
+
+    if (m == 0)
+    {
+        return;
+    }
+    ADC_disablePPBEventInterrupt(acq->adcBase[ch], (ADC_PPBNumber)acq->soc[ch],
+                                 ADC_EVT_TRIPHI | ADC_EVT_TRIPLO |
+                                 ADC_EVT_ZERO);
+    ADC_disablePPBEvent(acq->adcBase[ch], (ADC_PPBNumber)acq->soc[ch],
+                        ADC_EVT_TRIPHI | ADC_EVT_TRIPLO | ADC_EVT_ZERO);
+    m->armed = 0;
+}
+
+void adc_monitor_rearm(const AdcAcq *acq, uint16_t ch)
+{
+    AdcMonitor_Channel *m = slotOf(acq, ch);
+
+    if ((m == 0) || (m->armed == 0U))
+    {
+        return;
+    }
+    ADC_clearPPBEventStatus(acq->adcBase[ch], (ADC_PPBNumber)acq->soc[ch],
+                            m->latched);
+    ADC_enablePPBEventInterrupt(acq->adcBase[ch], (ADC_PPBNumber)acq->soc[ch],
+                                m->latched);
+}
+
+void adc_monitor_setCallback(const AdcAcq *acq, uint16_t ch,
+                             AdcMonitor_Callback callback, void *arg)
+{
+    AdcMonitor_Channel *m = slotOf(acq, ch);
+    bool wasDisabled;
+
+    if (m == 0)
+    {
+        return;
+    }
+    wasDisabled = Interrupt_disableGlobal();
+    m->callback    = callback;
+    m->callbackArg = arg;
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
+
+bool adc_monitor_snapshot(const AdcAcq *acq, uint16_t ch,
+                          AdcMonitor_Channel *dst)
+{
+    AdcMonitor_Channel *m = slotOf(acq, ch);
+    bool wasDisabled;
+
+    if ((m == 0) || (m->armed == 0U))
+    {
+        return false;
+    }
+    wasDisabled = Interrupt_disableGlobal();
+    *dst = *m;
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Event interrupt: only entered on a violation
+//---------------------------------------------------------------------------
+static void handleEvents(uint16_t a)
+{
+    uint32_t base = ADCA_BASE + ((uint32_t)a << 7);
+    uint32_t resultBase = ADCARESULT_BASE + ((uint32_t)a << 5);
+    uint16_t p;
+
+    for (p = 0; p < ADC_ACQ_NUM_PPBS; p++)
+    {
+        AdcMonitor_Channel *m = &monitor[a][p];
+        uint16_t flags;
+
+        if (m->armed == 0U)
+        {
+            continue;
+        }
+        flags = ADC_getPPBEventStatus(base, (ADC_PPBNumber)p) & m->events;
+        if (flags == 0U)
+        {
+            continue;
+        }
+
+        m->lastEvents = flags;
+        m->lastResult = ADC_readPPBResult(resultBase, (ADC_PPBNumber)p);
+        m->lastDelay  = ADC_getPPBDelayTimeStamp(base, (ADC_PPBNumber)p);
+        if (m->lastDelay > m->maxDelay)
+        {
+            m->maxDelay = m->lastDelay;
+        }
+        if ((flags & ADC_EVT_TRIPHI) != 0U)
+        {
+            m->tripHi++;
+        }
+        if ((flags & ADC_EVT_TRIPLO) != 0U)
+        {
+            m->tripLo++;
+        }
+        if ((flags & ADC_EVT_ZERO) != 0U)
+        {
+            m->zeroCross++;
+        }
+
+        if ((flags & m->latched) != 0U)
+        {
+            ADC_disablePPBEventInterrupt(base, (ADC_PPBNumber)p,
+                                         flags & m->latched);
+        }
+        ADC_clearPPBEventStatus(base, (ADC_PPBNumber)p, flags);
+
+        if (m->callback != 0)
+        {
+            m->callback(m->ch, flags, m->lastResult, m->callbackArg);
+        }
+    }
+
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP10);
+}
+
+static __interrupt void adcAEventISR(void)
+{
+    handleEvents(0);
+}
+
+static __interrupt void adcBEventISR(void)
+{
+    handleEvents(1);
+}
+
+static __interrupt void adcCEventISR(void)
+{
+    handleEvents(2);
+}
+
+static __interrupt void adcDEventISR(void)
+{
+    handleEvents(3);
+}
@@ -0,0 +1,86 @@
+//#############################################################################
+// File: adc_monitor.h
+// Chapter: ADC
+// Code description: hardware threshold monitoring on the ADC post-processing
+// blocks. Each watched channel gets a PPB (PPB n serves SOC n, as set up by
+// adc_acq) with a reference level, high/low trip limits and optional
+// zero-crossing detection around the reference. The PPB compares every
+// conversion itself; the CPU only runs when a limit is violated, through
+// the ADC event interrupt (PIE group 10), which records the event, the PPB
+// result and the trigger-to-conversion delay stamped by the PPB.
+//
+// A latched event disables its own interrupt after firing, so a signal that
+// stays out of its window costs one interrupt instead of one per sample;
+// adc_monitor_rearm() enables it again.
+//#############################################################################
+
+#ifndef ADC_MONITOR_H
+#define ADC_MONITOR_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+#include "adc_acq.h"
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef void (*AdcMonitor_Callback)(uint16_t ch, uint16_t events,
+                                    int32_t ppbResult, void *arg);
+
+// Per-channel state. Counters are written by the event ISR only.
+typedef struct
+{
+    uint16_t armed;             // Channel is watched
+    uint16_t ch;                // Channel in the acquisition table
+    uint16_t events;            // Enabled ADC_EVT_* flags
+    uint16_t latched;           // ADC_EVT_* flags that latch
+    uint32_t tripHi;            // Event counts
+    uint32_t tripLo;
+    uint32_t zeroCross;
+    uint16_t lastEvents;        // Flags of the last event interrupt
+    int32_t  lastResult;        // PPB result (sample - reference) then
+    uint16_t lastDelay;         // SYSCLK from trigger to conversion start
+    uint16_t maxDelay;
+    AdcMonitor_Callback callback;
+    void    *callbackArg;
+} AdcMonitor_Channel;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Watch channel ch of acq. Levels are in single-conversion codes, signed in
+// differential mode (as stored by adc_acq with osr = 1): reference is the
+// zero-crossing level, hiLimit/loLimit the absolute window. events is any
+// of ADC_EVT_TRIPHI, ADC_EVT_TRIPLO and ADC_EVT_ZERO; the ones also in
+// latch are disabled after firing. Registers and enables the ADC's event
+// interrupt. Returns false if the channel's SOC has no PPB (SOC 4 and up).
+bool adc_monitor_watch(const AdcAcq *acq, uint16_t ch, int32_t reference,
+                       int32_t hiLimit, int32_t loLimit, uint16_t events,
+                       uint16_t latch);
+
+// Stop watching channel ch (its PPB keeps any offset trim).
+void adc_monitor_unwatch(const AdcAcq *acq, uint16_t ch);
+
+// Enable latched events of channel ch again.
+void adc_monitor_rearm(const AdcAcq *acq, uint16_t ch);
+
+// Called from the event ISR, after the counters are updated.
+void adc_monitor_setCallback(const AdcAcq *acq, uint16_t ch,
+                             AdcMonitor_Callback callback, void *arg);
+
+// Copy the state of channel ch with interrupts masked. Returns false if the
+// channel is not watched.
+bool adc_monitor_snapshot(const AdcAcq *acq, uint16_t ch,
+                          AdcMonitor_Channel *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_MONITOR_H
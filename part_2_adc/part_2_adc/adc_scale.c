@@ -0,0 +1,79 @@
+//#############################################################################
+// File: adc_scale.c
+// Chapter: ADC
+// Code description: batched raw-to-units conversion. See adc_scale.h.
+//#############################################################################
+
+#include "adc_scale.h"
+
+//---------------------------------------------------------------------------
+// Set up a conversion
+//---------------------------------------------------------------------------
+void adc_scale_init(AdcScale *s, float32_t unitsPerCode, float32_t offsetUnits,
+                    bool isSigned)
+{
+    float32_t offsetQ16 = offsetUnits * 65536.0f + 32768.0f; // +0.5 LSB: round
+
+    s->gain     = (int32_t)(unitsPerCode * 65536.0f + 0.5f);
+    s->offset   = (int32_t)((offsetQ16 >= 0.0f) ? (offsetQ16 + 0.5f)
+                                                : (offsetQ16 - 0.5f));
+    s->gainF    = unitsPerCode;
+    s->offsetF  = offsetUnits;
+    s->isSigned = isSigned;
+}
+
+//---------------------------------------------------------------------------
+// Fixed-point pass: one 32-bit multiply-add and a shift per sample
+//---------------------------------------------------------------------------
+void adc_scale_fixed(const AdcScale *s, const uint16_t *raw, int16_t *dst,
+                     uint16_t n)
+{
+    int32_t gain   = s->gain;
+    int32_t offset = s->offset;
+    uint16_t i;
+
+    if (s->isSigned)
+    {
+        const int16_t *code = (const int16_t *)raw;
+
+        for (i = 0; i < n; i++)
+        {
+            dst[i] = (int16_t)(((int32_t)code[i] * gain + offset) >> 16);
+        }
+    }
+    else
+    {
+        for (i = 0; i < n; i++)
+        {
+            dst[i] = (int16_t)(((int32_t)raw[i] * gain + offset) >> 16);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------
+// Float pass
+//---------------------------------------------------------------------------
+void adc_scale_float(const AdcScale *s, const uint16_t *raw, float32_t *dst,
+                     uint16_t n)
+{
+    float32_t gain   = s->gainF;
+    float32_t offset = s->offsetF;
+    uint16_t i;
+
+    if (s->isSigned)
+    {
+        const int16_t *code = (const int16_t *)raw;
+
+        for (i = 0; i < n; i++)
+        {
+            dst[i] = (float32_t)code[i] * gain + offset;
+        }
+    }
+    else
+    {
+        for (i = 0; i < n; i++)
+        {
+            dst[i] = (float32_t)raw[i] * gain + offset;
+        }
+    }
+}
@@ -0,0 +1,85 @@
+//#############################################################################
+// File: adc_scale.h
+// Chapter: ADC
+// Code description: batched conversion of raw ADC codes to engineering
+// units, run by the consumer on whole blocks instead of per sample in the
+// ISR. The ISR only stores the 16-bit code; nothing else is kept per sample.
+//
+// Fixed-point pass:  out = (code * gain + offset) >> 16   (one multiply-add)
+// with gain and offset in Q16 output units, so the same routine produces
+// millivolts, Q15 fractions of full scale or any other 16-bit unit
+// depending on how the AdcScale was set up. A float pass is provided for
+// code that wants volts directly.
+//
+// Stored codes are unsigned in single-ended mode and signed (two's
+// complement around 0 V, see adc_acq.h) in differential mode; the AdcScale
+// records which, so one set of routines serves both.
+//#############################################################################
+
+#ifndef ADC_SCALE_H
+#define ADC_SCALE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// LaunchPad XL: VREFHI = 3.0 V, VREFLO = 0 V
+#define ADC_SCALE_VREF          3.0f
+
+// 12-bit single-ended: unsigned code 0..4095 for 0..VREF
+#define ADC_SCALE_SE12_VOLTS_PER_CODE   (ADC_SCALE_VREF / 4095.0f)
+#define ADC_SCALE_SE12_Q15_PER_CODE     (32767.0f / 4095.0f)
+
+// 16-bit differential: signed code -32768..32767 for -VREF..+VREF
+#define ADC_SCALE_DIFF16_VOLTS_PER_CODE (2.0f * ADC_SCALE_VREF / 65536.0f)
+#define ADC_SCALE_DIFF16_Q15_PER_CODE   1.0f
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    int32_t   gain;         // Output units per code, Q16
+    int32_t   offset;       // Output units at code 0, Q16, rounding included
+    float32_t gainF;        // Same conversion for the float pass
+    float32_t offsetF;
+    bool      isSigned;     // Codes are int16_t (differential mode)
+} AdcScale;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// out = code * unitsPerCode + offsetUnits, with code read as int16_t when
+// isSigned. Float is only used here, once.
+void adc_scale_init(AdcScale *s, float32_t unitsPerCode, float32_t offsetUnits,
+                    bool isSigned);
+
+// Fixed-point pass over n codes; the results must fit in 16 bits.
+void adc_scale_fixed(const AdcScale *s, const uint16_t *raw, int16_t *dst,
+                     uint16_t n);
+
+// Float pass over n codes.
+void adc_scale_float(const AdcScale *s, const uint16_t *raw, float32_t *dst,
+                     uint16_t n);
+
+// Single code, for occasional use outside a batch.
+static inline int16_t adc_scale_one(const AdcScale *s, uint16_t code)
+{
+    int32_t c = s->isSigned ? (int32_t)(int16_t)code : (int32_t)code;
+
+    return (int16_t)((c * s->gain + s->offset) >> 16);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_SCALE_H
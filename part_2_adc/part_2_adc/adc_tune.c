@@ -0,0 +1,240 @@
+//#############################################################################
+// File: adc_tune.c
+// Chapter: ADC
+// Code description: ACQPS / prescaler sweep and config header generation.
+// See adc_tune.h.
+//#############################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include "device.h"
+#include "adc_tune.h"
+#include "adc_acq.h"
+
+//---------------------------------------------------------------------------
+// Sweep grid
+//---------------------------------------------------------------------------
+// S+H windows, SYSCLK - 1, roughly 25 % apart (75 ns .. 2.56 us at 200 MHz)
+static const uint16_t tuneWindows[ADC_TUNE_NUM_WINDOWS] =
+{
+    14, 19, 24, 29, 39, 49, 63, 79, 99, 127, 159, 199, 255, 319, 399, 511
+};
+
+#define TUNE_SETTLED_ACQPS      511U
+#define TUNE_SLOWEST_PRESCALE   ADC_CLK_DIV_8_0
+#define TUNE_THROUGHPUT_RUNS    4U
+#define TUNE_MIN_ACQPS_12BIT    14U     // Same limits as adc_acq
+#define TUNE_MIN_ACQPS_16BIT    63U
+
+static inline uint32_t resultBaseOf(uint32_t adcBase)
+{
+    return ADCARESULT_BASE + ((adcBase - ADCA_BASE) >> 2);
+}
+
+//---------------------------------------------------------------------------
+// Settling: precharge SOC0 at the far rail, then the test input on SOC1
+//---------------------------------------------------------------------------
+static void measureSettling(const AdcTune_Config *cfg, ADC_ClkPrescale prescale,
+                            uint16_t acqps, float32_t *mean, float32_t *sd)
+{
+    uint32_t resultBase = resultBaseOf(cfg->adcBase);
+    float32_t first = 0.0f;
+    float32_t sum = 0.0f;
+    float32_t sumSq = 0.0f;
+    float32_t m;
+    uint16_t i;
+
+    ADC_setPrescaler(cfg->adcBase, prescale);
+    ADC_setupSOC(cfg->adcBase, ADC_SOC_NUMBER0, ADC_TRIGGER_SW_ONLY,
+                 cfg->precharge, TUNE_SETTLED_ACQPS);
+    ADC_setupSOC(cfg->adcBase, ADC_SOC_NUMBER1, ADC_TRIGGER_SW_ONLY,
+                 cfg->channel, acqps);
+    ADC_setInterruptSource(cfg->adcBase, ADC_INT_NUMBER1, ADC_SOC_NUMBER1);
+
+    for (i = 0; i < cfg->samples; i++)
+    {
+        float32_t x;
+
+        ADC_clearInterruptStatus(cfg->adcBase, ADC_INT_NUMBER1);
+        ADC_forceMultipleSOC(cfg->adcBase, ADC_FORCE_SOC0 | ADC_FORCE_SOC1);
+        while (!ADC_getInterruptStatus(cfg->adcBase, ADC_INT_NUMBER1))
+        {
+        }
+
+        // Relative to the first sample, so float keeps the LSBs
+        x = (float32_t)ADC_readResult(resultBase, ADC_SOC_NUMBER1);
+        if (i == 0U)
+        {
+            first = x;
+        }
+        x -= first;
+        sum   += x;
+        sumSq += x * x;
+    }
+
+    m = sum / (float32_t)cfg->samples;
+    *mean = first + m;
+    *sd   = sqrtf(fmaxf(sumSq / (float32_t)cfg->samples - m * m, 0.0f));
+}
+
+//---------------------------------------------------------------------------
+// Throughput: all 16 SOCs on the test input, forced at once
+//---------------------------------------------------------------------------
+static float32_t measureThroughput(const AdcTune_Config *cfg,
+                                   ADC_ClkPrescale prescale, uint16_t acqps)
+{
+    uint32_t best = 0xFFFFFFFFUL;
+    uint16_t k;
+
+    ADC_setPrescaler(cfg->adcBase, prescale);
+    for (k = 0; k < 16U; k++)
+    {
+        ADC_setupSOC(cfg->adcBase, (ADC_SOCNumber)k, ADC_TRIGGER_SW_ONLY,
+                     cfg->channel, acqps);
+    }
+    ADC_setInterruptSource(cfg->adcBase, ADC_INT_NUMBER1, ADC_SOC_NUMBER15);
+
+    for (k = 0; k < TUNE_THROUGHPUT_RUNS; k++)
+    {
+        uint32_t t0;
+        uint32_t t1;
+
+        ADC_clearInterruptStatus(cfg->adcBase, ADC_INT_NUMBER1);
+        t0 = CPUTimer_getTimerCount(ADC_TUNE_TIMESTAMP_BASE);
+        ADC_forceMultipleSOC(cfg->adcBase, 0xFFFFU);
+        while (!ADC_getInterruptStatus(cfg->adcBase, ADC_INT_NUMBER1))
+        {
+        }
+        t1 = CPUTimer_getTimerCount(ADC_TUNE_TIMESTAMP_BASE);
+
+        // Down-counter: elapsed = t0 - t1
+        if (t0 - t1 < best)
+        {
+            best = t0 - t1;
+        }
+    }
+    return (float32_t)best / 16.0f;
+}
+
+//---------------------------------------------------------------------------
+// Header
+//---------------------------------------------------------------------------
+static void writeHeader(AdcTune *t)
+{
+    const AdcTune_Point *p = &t->point[t->best];
+    uint16_t div2 = (uint16_t)p->prescale + 2U;   // ADCCLK divider * 2
+
+    snprintf(t->header, ADC_TUNE_HEADER_LEN,
+             "// adc_tuned.h: generated by adc_tune_run()\n"
+             "// ADC%c ADCIN%u (precharge ADCIN%u), %u-bit, %u samples per setting\n"
+             "// Settling error %.2f LSB (bound %.2f), noise %.2f LSB rms\n"
+             "#ifndef ADC_TUNED_H\n"
+             "#define ADC_TUNED_H\n"
+             "#define ADC_TUNED_PRESCALE ADC_CLK_DIV_%u_%u\n"
+             "#define ADC_TUNED_ACQPS %u\n"
+             "#define ADC_TUNED_SPS %luUL // Measured, one ADC\n"
+             "#define ADC_TUNED_PASS %u\n"
+             "#endif // ADC_TUNED_H\n",
+             'A' + (int)((t->cfg.adcBase - ADCA_BASE) >> 7),
+             (unsigned)t->cfg.channel, (unsigned)t->cfg.precharge,
+             (t->cfg.resolution == ADC_RESOLUTION_16BIT) ? 16U : 12U,
+             t->cfg.samples,
+             p->errorLsb, t->cfg.maxErrorLsb, p->noiseLsb,
+             div2 / 2U, ((div2 & 1U) != 0U) ? 5U : 0U,
+             p->acqps,
+             (unsigned long)p->sps,
+             p->pass ? 1U : 0U);
+}
+
+//---------------------------------------------------------------------------
+// Sweep
+//---------------------------------------------------------------------------
+bool adc_tune_run(AdcTune *t, const AdcTune_Config *cfg)
+{
+    uint16_t minAcqps = (cfg->resolution == ADC_RESOLUTION_16BIT) ?
+                        TUNE_MIN_ACQPS_16BIT : TUNE_MIN_ACQPS_12BIT;
+    uint16_t p;
+    float32_t noise;
+
+    t->cfg   = *cfg;
+    t->count = 0;
+    t->best  = -1;
+    t->header[0] = '\0';
+    if (cfg->samples == 0U)
+    {
+        return false;
+    }
+
+    // Free-running timestamps
+    adc_acq_startTimestamp(ADC_TUNE_TIMESTAMP_BASE);
+
+    ADC_setPrescaler(cfg->adcBase, TUNE_SLOWEST_PRESCALE);
+    ADC_setMode(cfg->adcBase, cfg->resolution, cfg->signalMode);
+    ADC_setInterruptPulseMode(cfg->adcBase, ADC_PULSE_END_OF_CONV);
+    ADC_setSOCPriority(cfg->adcBase, ADC_PRI_ALL_ROUND_ROBIN);
+    ADC_enableConverter(cfg->adcBase);
+    ADC_enableInterrupt(cfg->adcBase, ADC_INT_NUMBER1);
+    DEVICE_DELAY_US(1000);
+
+    // Settled value: longest window, slowest clock
+    measureSettling(cfg, TUNE_SLOWEST_PRESCALE, TUNE_SETTLED_ACQPS,
+                    &t->settled, &noise);
+
+    // Every whole divider from the fastest legal ADCCLK, windows up to the
+    // first pass (longer ones are only slower)
+    for (p = (uint16_t)ADC_CLK_DIV_1_0; p <= (uint16_t)TUNE_SLOWEST_PRESCALE;
+         p += 2U)
+    {
+        uint16_t w;
+
+        if ((cfg->sysclkHz * 2UL) / (p + 2UL) > ADC_TUNE_MAX_ADCCLK)
+        {
+            continue;
+        }
+        for (w = 0; (w < ADC_TUNE_NUM_WINDOWS) &&
+                    (t->count < ADC_TUNE_MAX_POINTS); w++)
+        {
+            AdcTune_Point *pt = &t->point[t->count];
+            float32_t mean;
+
+            if (tuneWindows[w] < minAcqps)
+            {
+                continue;
+            }
+            pt->prescale = (ADC_ClkPrescale)p;
+            pt->acqps    = tuneWindows[w];
+            measureSettling(cfg, pt->prescale, pt->acqps, &mean,
+                            &pt->noiseLsb);
+            pt->errorLsb      = fabsf(mean - t->settled);
+            pt->cyclesPerConv = measureThroughput(cfg, pt->prescale,
+                                                  pt->acqps);
+            pt->sps  = (float32_t)cfg->sysclkHz / pt->cyclesPerConv;
+            pt->pass = (pt->errorLsb <= cfg->maxErrorLsb);
+
+            // Fastest pass, or closest miss while nothing passes
+            if ((t->best < 0) ||
+                (pt->pass && (!t->point[t->best].pass ||
+                              (pt->cyclesPerConv <
+                               t->point[t->best].cyclesPerConv))) ||
+                (!pt->pass && !t->point[t->best].pass &&
+                 (pt->errorLsb < t->point[t->best].errorLsb)))
+            {
+                t->best = (int16_t)t->count;
+            }
+            t->count++;
+            if (pt->pass)
+            {
+                break;
+            }
+        }
+    }
+
+    ADC_disableInterrupt(cfg->adcBase, ADC_INT_NUMBER1);
+    ADC_clearInterruptStatus(cfg->adcBase, ADC_INT_NUMBER1);
+    if (t->best < 0)
+    {
+        return false;
+    }
+    writeHeader(t);
+    return t->point[t->best].pass;
+}
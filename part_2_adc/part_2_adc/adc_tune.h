@@ -0,0 +1,96 @@
+//#############################################################################
+// File: adc_tune.h
+// Chapter: ADC
+// Code description: S+H window (ACQPS) and ADC clock prescaler autotuner.
+// The right window depends on the source impedance driving the pin, which
+// the fixed ADC_ACQPS_TICKS cannot know. With the actual source connected
+// to a test input and a second input of the same ADC held at the opposite
+// end of the range (e.g. tied to VREFLO), the tuner converts the precharge
+// input and then the test input, so the sampling capacitor always starts
+// from the far rail, and compares the test result with the settled value
+// taken at the longest window and slowest clock:
+//  - settling error: |mean - settled mean| in LSB
+//  - noise:          standard deviation in LSB
+//  - throughput:     measured SYSCLK per conversion, 16 SOCs back to back
+//
+// Every whole prescaler divider with ADCCLK <= 50 MHz is swept with
+// increasing windows up to the first one within the error bound. The
+// fastest passing setting is written out as a config header
+// (adcTune.header, a C string to save from the debugger as adc_tuned.h).
+//
+// Runs before adc_acq_init(): it reprograms the SOCs and ADCINT1 of the
+// ADC under test, which adc_acq_init() then sets up again.
+//#############################################################################
+
+#ifndef ADC_TUNE_H
+#define ADC_TUNE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define ADC_TUNE_MAX_ADCCLK     50000000UL  // Datasheet limit
+#define ADC_TUNE_NUM_WINDOWS    16U         // ACQPS candidates per prescaler
+#define ADC_TUNE_MAX_POINTS     96U         // Measured settings kept
+#define ADC_TUNE_HEADER_LEN     640U
+
+// Timestamps (free-running, shared with adc_acq)
+#define ADC_TUNE_TIMESTAMP_BASE CPUTIMER1_BASE
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t       adcBase;
+    ADC_Channel    channel;         // Test input, driven by the real source
+    ADC_Channel    precharge;       // Same ADC, held at the other rail
+    ADC_Resolution resolution;
+    ADC_SignalMode signalMode;
+    uint16_t       samples;         // Conversions per setting
+    float32_t      maxErrorLsb;     // Settling error bound
+    uint32_t       sysclkHz;
+} AdcTune_Config;
+
+typedef struct
+{
+    ADC_ClkPrescale prescale;
+    uint16_t  acqps;
+    float32_t errorLsb;
+    float32_t noiseLsb;
+    float32_t cyclesPerConv;        // Measured, SYSCLK
+    float32_t sps;                  // Single-ADC throughput
+    bool      pass;
+} AdcTune_Point;
+
+typedef struct
+{
+    AdcTune_Config cfg;
+    float32_t settled;              // Reference mean, codes
+    uint16_t  count;
+    AdcTune_Point point[ADC_TUNE_MAX_POINTS];
+    int16_t   best;                 // Index in point[], -1 if nothing passed
+    char      header[ADC_TUNE_HEADER_LEN];
+} AdcTune;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Run the sweep (blocking: up to 80 settings of 2 * samples + 64
+// conversions each) and generate the header. Returns false if no setting
+// met the bound; the header then holds the closest one, marked as failing.
+bool adc_tune_run(AdcTune *t, const AdcTune_Config *cfg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ADC_TUNE_H
@@ -0,0 +1,113 @@
+//#############################################################################
+// File: buf_pool.c
+// Chapter: DMA / ADC
+// Code description: capture block pool with lock-free hand-over between one
+// producer (ISR) and one consumer (main loop). See buf_pool.h.
+//#############################################################################
+
+#include "buf_pool.h"
+
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+//---------------------------------------------------------------------------
+// Build the pool
+//---------------------------------------------------------------------------
+void buf_pool_init(BufPool *pool, BufDesc *desc, uint16_t *storage,
+                   uint16_t count, uint16_t channels, uint16_t frames,
+                   uint16_t chStride, uint16_t frStride)
+{
+    uint16_t i;
+    uint32_t blockWords = (uint32_t)channels * frames;
+
+    if (count > BUF_POOL_MAX_BLOCKS)
+    {
+        count = BUF_POOL_MAX_BLOCKS;
+    }
+
+    pool->desc  = desc;
+    pool->count = count;
+    pool->produced = 0;
+    pool->dropped  = 0;
+    spsc_init(&pool->readyQ, pool->readyBuf, BUF_POOL_MAX_BLOCKS);
+    spsc_init(&pool->freeQ, pool->freeBuf, BUF_POOL_MAX_BLOCKS);
+
+    for (i = 0; i < count; i++)
+    {
+        desc[i].data     = storage + (uint32_t)i * blockWords;
+        desc[i].channels = channels;
+        desc[i].frames   = frames;
+        desc[i].chStride = chStride;
+        desc[i].frStride = frStride;
+        desc[i].index    = i;
+        desc[i].state    = BUF_STATE_FREE;
+        desc[i].sequence = 0;
+
+        spsc_push(&pool->freeQ, i);
+    }
+}
+
+//---------------------------------------------------------------------------
+// Producer side
+//---------------------------------------------------------------------------
+BufDesc *buf_pool_startFill(BufPool *pool)
+{
+    BufDesc *d;
+    uint16_t i;
+
+    if (!spsc_pop(&pool->freeQ, &i))
+    {
+        return NULL;
+    }
+
+    d = &pool->desc[i];
+    d->state = BUF_STATE_FILLING;
+    return d;
+}
+
+BufDesc *buf_pool_rotate(BufPool *pool, BufDesc *filled)
+{
+    BufDesc *next = buf_pool_startFill(pool);
+
+    if (next == NULL)
+    {
+        // Nothing free: keep filling the same block, drop its contents.
+        pool->dropped++;
+        return filled;
+    }
+
+    filled->sequence = pool->produced++;
+    filled->state = BUF_STATE_READY;
+    spsc_push(&pool->readyQ, filled->index);   // Publish last
+    return next;
+}
+
+//---------------------------------------------------------------------------
+// Consumer side
+//---------------------------------------------------------------------------
+BufDesc *buf_pool_acquire(BufPool *pool)
+{
+    BufDesc *d;
+    uint16_t i;
+
+    if (!spsc_pop(&pool->readyQ, &i))
+    {
+        return NULL;
+    }
+
+    d = &pool->desc[i];
+    d->state = BUF_STATE_OWNED;
+    return d;
+}
+
+void buf_pool_release(BufPool *pool, BufDesc *d)
+{
+    d->state = BUF_STATE_FREE;
+    spsc_push(&pool->freeQ, d->index);
+}
+
+uint16_t buf_pool_readyCount(const BufPool *pool)
+{
+    return spsc_count(&pool->readyQ);
+}
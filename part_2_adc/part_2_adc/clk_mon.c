@@ -0,0 +1,125 @@
+//#############################################################################
+// File: clk_mon.c
+// Chapter: Clocking
+// Code description: SYSCLK vs crystal measurement. See clk_mon.h.
+//#############################################################################
+
+#include <math.h>
+#include "clk_mon.h"
+#include "adc_acq.h"
+
+//---------------------------------------------------------------------------
+// Helpers
+//---------------------------------------------------------------------------
+// Both counts back to back; the timers count down
+static void snapshot(const ClkMon *m, uint32_t *sys, uint32_t *ref)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+
+    *ref = HWREG(m->refTimer + CPUTIMER_O_TIM);
+    *sys = HWREG(m->sysTimer + CPUTIMER_O_TIM);
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
+
+static void closeWindow(ClkMon *m, uint32_t sysTicks, uint32_t refTicks)
+{
+    float32_t ppm;
+
+    m->measuredHz = (uint32_t)(((uint64_t)sysTicks * m->refHz +
+                                refTicks / 2U) / refTicks);
+    ppm = (float32_t)((int32_t)(m->measuredHz - m->nominalHz)) * 1.0e6f /
+          (float32_t)m->nominalHz;
+
+    m->errorPpm = ppm;
+    if (fabsf(ppm) > m->worstPpm)
+    {
+        m->worstPpm = fabsf(ppm);
+    }
+    m->ok = (fabsf(ppm) <= m->tolPpm);
+    if (!m->ok)
+    {
+        m->faults++;
+    }
+    m->measurements++;
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+void clk_mon_init(ClkMon *m, uint32_t sysTimer, uint32_t refTimer,
+                  uint32_t refHz, uint32_t nominalHz, uint32_t windowUs,
+                  float32_t tolPpm)
+{
+    m->sysTimer     = sysTimer;
+    m->refTimer     = refTimer;
+    m->refHz        = refHz;
+    m->nominalHz    = nominalHz;
+    m->windowTicks  = (uint32_t)(((uint64_t)refHz * windowUs) / 1000000UL);
+    m->tolPpm       = tolPpm;
+    m->measuredHz   = 0;
+    m->errorPpm     = 0.0f;
+    m->worstPpm     = 0.0f;
+    m->ok           = false;
+    m->measurements = 0;
+    m->faults       = 0;
+    m->stalls       = 0;
+
+    CPUTimer_selectClockSource(refTimer, CPUTIMER_CLOCK_SOURCE_XTAL,
+                               CPUTIMER_CLOCK_PRESCALER_1);
+    adc_acq_startTimestamp(refTimer);
+    adc_acq_startTimestamp(sysTimer);
+
+    snapshot(m, &m->sysStart, &m->refStart);
+}
+
+//---------------------------------------------------------------------------
+// Background measurement
+//---------------------------------------------------------------------------
+bool clk_mon_poll(ClkMon *m)
+{
+    uint32_t sys;
+    uint32_t ref;
+    uint32_t sysTicks;
+    uint32_t refTicks;
+    uint64_t expected;
+
+    snapshot(m, &sys, &ref);
+    sysTicks = m->sysStart - sys;
+    refTicks = m->refStart - ref;
+
+    if (refTicks < m->windowTicks)
+    {
+        // Twice the window in SYSCLK with the crystal count short: stalled
+        expected = ((uint64_t)m->windowTicks * m->nominalHz) / m->refHz;
+        if ((uint64_t)sysTicks > 2U * expected)
+        {
+            m->stalls++;
+            m->ok = false;
+            m->sysStart = sys;
+            m->refStart = ref;
+        }
+        return false;
+    }
+
+    closeWindow(m, sysTicks, refTicks);
+    m->sysStart = sys;
+    m->refStart = ref;
+    return true;
+}
+
+bool clk_mon_measure(ClkMon *m)
+{
+    uint32_t measurements = m->measurements;
+    uint32_t stalls = m->stalls;
+
+    snapshot(m, &m->sysStart, &m->refStart);
+    while ((m->measurements == measurements) && (m->stalls == stalls))
+    {
+        clk_mon_poll(m);
+    }
+    return m->ok;
+}
@@ -0,0 +1,80 @@
+//#############################################################################
+// File: clk_mon.h
+// Chapter: Clocking
+// Code description: background SYSCLK check against the crystal. CPU Timer
+// 2 is clocked straight from XTAL (its clock source mux), a free-running
+// timer counts SYSCLK, and the two counts over a window of crystal ticks
+// give the measured SYSCLK and its error against the nominal frequency in
+// ppm. clk_mon_poll() is non-blocking (two timer reads per call), for the
+// background loop; clk_mon_measure() blocks for one window, for startup.
+//
+// SYSCLK comes from the crystal through the PLL, so a healthy clock reads
+// 0 ppm +- one crystal tick per window: this catches a PLL not locked, a
+// wrong multiplier/divider or a fallback to INTOSC after a missing-clock
+// event (the crystal timer then stops: counted in stalls), not the
+// crystal's own tolerance. A window of W us resolves 1e6 / (W * XTAL MHz)
+// ppm.
+//
+// The measured frequency can be fed to rate_gen_setClock() so that timer
+// sample rates follow the real SYSCLK.
+//#############################################################################
+
+#ifndef CLK_MON_H
+#define CLK_MON_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t  sysTimer;             // Free running at SYSCLK (e.g. CPUTIMER1)
+    uint32_t  refTimer;             // CPUTIMER2_BASE (only one with a mux)
+    uint32_t  refHz;                // Crystal
+    uint32_t  nominalHz;            // Expected SYSCLK
+    uint32_t  windowTicks;          // Crystal ticks per measurement
+    float32_t tolPpm;               // Beyond this the clock is faulty
+
+    // Window in progress
+    uint32_t  sysStart;
+    uint32_t  refStart;
+
+    // Results
+    uint32_t  measuredHz;           // Last measurement
+    float32_t errorPpm;             // (measured - nominal) / nominal
+    float32_t worstPpm;             // Largest |errorPpm| seen
+    bool      ok;                   // Last window within tolPpm
+    uint32_t  measurements;
+    uint32_t  faults;               // Windows outside tolPpm
+    uint32_t  stalls;               // Crystal timer not counting
+} ClkMon;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Clock refTimer from XTAL and start both timers free running (sysTimer is
+// left alone if it already runs), then open the first window.
+void clk_mon_init(ClkMon *m, uint32_t sysTimer, uint32_t refTimer,
+                  uint32_t refHz, uint32_t nominalHz, uint32_t windowUs,
+                  float32_t tolPpm);
+
+// Returns true when a window has just been closed (results updated); the
+// next one starts there.
+bool clk_mon_poll(ClkMon *m);
+
+// Measure one full window now, blocking. Returns m->ok.
+bool clk_mon_measure(ClkMon *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CLK_MON_H
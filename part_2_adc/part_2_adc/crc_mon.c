@@ -0,0 +1,173 @@
+//#############################################################################
+// File: crc_mon.c
+// Chapter: Memory
+// Code description: time-sliced CRC-32 over registered regions. See
+// crc_mon.h.
+//#############################################################################
+
+#include "crc_mon.h"
+
+//---------------------------------------------------------------------------
+// CRC-32
+//---------------------------------------------------------------------------
+// Reflected 0xEDB88320, one entry per nibble
+static const uint32_t crcNibble[16] =
+{
+    0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+    0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+    0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+    0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+};
+
+// Both bytes of each word, low byte first
+static uint32_t crcUpdate(uint32_t crc, const uint16_t *p, uint32_t words)
+{
+    uint32_t i;
+    uint16_t b;
+
+    for (i = 0; i < words; i++)
+    {
+        for (b = 0; b < 4U; b++)
+        {
+            crc = (crc >> 4) ^ crcNibble[(crc ^ (p[i] >> (4U * b))) & 0xFU];
+        }
+    }
+    return crc;
+}
+
+uint32_t crc_mon_crc32(const void *addr, uint32_t words)
+{
+    return ~crcUpdate(0xFFFFFFFFUL, (const uint16_t *)addr, words);
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+void crc_mon_init(CrcMon *m, CrcMon_Region *storage, uint16_t maxRegions,
+                  uint16_t sliceWords)
+{
+    m->region     = storage;
+    m->maxRegions = maxRegions;
+    m->count      = 0;
+    m->sliceWords = (sliceWords != 0U) ? sliceWords : 1U;
+    m->current    = 0;
+    m->offset     = 0;
+    m->crc        = 0xFFFFFFFFUL;
+    m->rounds     = 0;
+    m->mismatches = 0;
+    m->firstBad   = CRC_MON_NONE;
+}
+
+uint16_t crc_mon_add(CrcMon *m, const void *addr, uint32_t words,
+                     uint32_t golden, bool hasGolden)
+{
+    CrcMon_Region *r;
+
+    if ((m->count >= m->maxRegions) || (words == 0U))
+    {
+        return CRC_MON_NONE;
+    }
+
+    r = &m->region[m->count];
+    r->addr       = (const uint16_t *)addr;
+    r->words      = words;
+    r->golden     = golden;
+    r->learned    = hasGolden;
+    r->lastCrc    = 0;
+    r->passes     = 0;
+    r->mismatches = 0;
+
+    return m->count++;
+}
+
+void crc_mon_relearn(CrcMon *m, uint16_t id)
+{
+    if (id >= m->count)
+    {
+        return;
+    }
+    m->region[id].learned = false;
+    if (m->current == id)
+    {
+        m->offset = 0;
+        m->crc    = 0xFFFFFFFFUL;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Background check
+//---------------------------------------------------------------------------
+bool crc_mon_step(CrcMon *m)
+{
+    CrcMon_Region *r;
+    uint32_t n;
+    uint32_t crc;
+
+    if (m->count == 0U)
+    {
+        return false;
+    }
+
+    r = &m->region[m->current];
+    n = r->words - m->offset;
+    if (n > m->sliceWords)
+    {
+        n = m->sliceWords;
+    }
+    m->crc = crcUpdate(m->crc, r->addr + m->offset, n);
+    m->offset += n;
+    if (m->offset < r->words)
+    {
+        return false;
+    }
+
+    // Region done
+    crc = ~m->crc;
+    r->lastCrc = crc;
+    if (!r->learned)
+    {
+        r->golden  = crc;
+        r->learned = true;
+        r->passes++;
+    }
+    else if (crc == r->golden)
+    {
+        r->passes++;
+    }
+    else
+    {
+        r->mismatches++;
+        m->mismatches++;
+        if (m->firstBad == CRC_MON_NONE)
+        {
+            m->firstBad = m->current;
+        }
+    }
+
+    m->offset = 0;
+    m->crc    = 0xFFFFFFFFUL;
+    if (++m->current >= m->count)
+    {
+        m->current = 0;
+        m->rounds++;
+    }
+    return true;
+}
+
+bool crc_mon_ok(const CrcMon *m)
+{
+    const CrcMon_Region *r;
+    uint16_t i;
+
+    for (i = 0; i < m->count; i++)
+    {
+        // Only regions checked at least once against a golden value
+        r = &m->region[i];
+        if (r->learned && ((r->passes + r->mismatches) != 0U) &&
+            (r->lastCrc != r->golden))
+        {
+            return false;
+        }
+    }
+    return true;
+}
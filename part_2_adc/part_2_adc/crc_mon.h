@@ -0,0 +1,101 @@
+//#############################################################################
+// File: crc_mon.h
+// Chapter: Memory
+// Code description: background integrity check of memory regions that must
+// not change (filter taps, lookup tables, configuration, code in RAM). Each
+// registered region has a golden CRC-32, either given (computed on the
+// host) or learned on its first pass; the regions are checked one after the
+// other, round robin, a few words per crc_mon_step() call, so the check can
+// run from the idle branch of the main loop without holding up anything.
+// Each region keeps pass / mismatch counts and the last CRC, and the
+// monitor the number of complete rounds and the first failing region.
+//
+// The F2837xD has no background CRC engine, so the slices are computed by
+// the CPU (nibble table, a few cycles per bit of data); sliceWords bounds
+// the time of one step.
+//
+// The CRC is the usual CRC-32 (zlib, reflected 0xEDB88320) of the region
+// as bytes, low byte of each 16-bit word first: a golden value can be
+// computed on the host with zlib.crc32() over the little-endian image.
+//#############################################################################
+
+#ifndef CRC_MON_H
+#define CRC_MON_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define CRC_MON_NONE            0xFFFFU     // No region / failed registration
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    const uint16_t *addr;
+    uint32_t words;
+    uint32_t golden;                // Expected CRC
+    bool     learned;               // golden valid (given or first pass)
+
+    // Status
+    uint32_t lastCrc;               // Last complete pass
+    uint32_t passes;                // Passes that matched
+    uint32_t mismatches;            // Passes that did not
+} CrcMon_Region;
+
+typedef struct
+{
+    CrcMon_Region *region;          // Storage for maxRegions entries
+    uint16_t maxRegions;
+    uint16_t count;
+    uint16_t sliceWords;            // Words per crc_mon_step() (e.g. 64)
+
+    // Pass in progress
+    uint16_t current;               // Region being checked
+    uint32_t offset;                // Words of it done
+    uint32_t crc;                   // Running CRC (not yet inverted)
+
+    // Status
+    uint32_t rounds;                // Complete rounds over all regions
+    uint32_t mismatches;            // Sum over the regions
+    uint16_t firstBad;              // First region to mismatch, CRC_MON_NONE
+} CrcMon;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+void crc_mon_init(CrcMon *m, CrcMon_Region *storage, uint16_t maxRegions,
+                  uint16_t sliceWords);
+
+// Add a region of words 16-bit words. With hasGolden false, the first pass
+// learns the golden CRC. Returns the region id, CRC_MON_NONE when full.
+uint16_t crc_mon_add(CrcMon *m, const void *addr, uint32_t words,
+                     uint32_t golden, bool hasGolden);
+
+// Forget the golden CRC of region id after a legitimate rewrite; the next
+// pass learns it again (a pass of it in progress is restarted).
+void crc_mon_relearn(CrcMon *m, uint16_t id);
+
+// Check the next sliceWords words. Returns true when a region pass has just
+// been completed (see its counts).
+bool crc_mon_step(CrcMon *m);
+
+// All regions matched on their last pass
+bool crc_mon_ok(const CrcMon *m);
+
+// CRC-32 of a whole region at once, e.g. for a golden value at startup
+uint32_t crc_mon_crc32(const void *addr, uint32_t words);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_MON_H
@@ -0,0 +1,235 @@
+//#############################################################################
+// File: decim.c
+// Chapter: ADC
+// Code description: CIC + polyphase FIR decimation. See decim.h.
+//#############################################################################
+
+#include "decim.h"
+
+//---------------------------------------------------------------------------
+// Built-in filters
+//---------------------------------------------------------------------------
+// Kaiser-windowed sinc (beta 6), cutoff 0.1 fs.
+const int16_t decimLowpass5[DECIM_LOWPASS5_TAPS] =
+{
+        -4,     -4,      0,      8,     17,     23,     18,      0,
+       -28,    -56,    -67,    -50,      0,     70,    134,    156,
+       112,      0,   -149,   -277,   -318,   -224,      0,    292,
+       539,    615,    435,      0,   -578,  -1089,  -1284,   -950,
+         0,   1484,   3247,   4919,   6117,   6552,   6117,   4919,
+      3247,   1484,      0,   -950,  -1284,  -1089,   -578,      0,
+       435,    615,    539,    292,      0,   -224,   -318,   -277,
+      -149,      0,    112,    156,    134,     70,      0,    -50,
+       -67,    -56,    -28,      0,     18,     23,     17,      8,
+         0,     -4,     -4
+};
+
+// Frequency-sampled 1 / sinc^3 up to 0.18 fs, raised-cosine to zero at
+// 0.3 fs, Kaiser window (beta 6).
+const int16_t decimCic3Comp[DECIM_CIC3_COMP_TAPS] =
+{
+         0,      0,      0,      0,      0,     -4,     -2,     12,
+         8,    -17,    -10,     -3,    -25,     80,    179,   -232,
+      -600,    431,   1549,   -540,  -3679,    -65,  10772,  17060,
+     10772,    -65,  -3679,   -540,   1549,    431,   -600,   -232,
+       179,     80,    -25,     -3,    -10,    -17,      8,     12,
+        -2,     -4,      0,      0,      0,      0,      0
+};
+
+//---------------------------------------------------------------------------
+// Configuration
+//---------------------------------------------------------------------------
+bool decim_init(Decim *d, uint16_t cicOrder, uint16_t cicRatio,
+                const int16_t *taps, uint16_t nTaps, uint16_t firRatio,
+                bool inSigned)
+{
+    uint32_t gain = 1;
+    uint32_t absSum = 0;
+    uint16_t i;
+
+    if (cicOrder > DECIM_CIC_MAX_ORDER)
+    {
+        return false;
+    }
+    if (cicOrder == 0U)
+    {
+        cicRatio = 1;
+    }
+    for (i = 0; i < cicOrder; i++)
+    {
+        gain *= cicRatio;
+        if ((cicRatio == 0U) || (gain > DECIM_CIC_MAX_GAIN))
+        {
+            return false;
+        }
+    }
+
+    if (taps != NULL)
+    {
+        if ((nTaps == 0U) || (nTaps > DECIM_FIR_MAX_TAPS) || (firRatio == 0U))
+        {
+            return false;
+        }
+        // |sum of products| < 2^15 * absSum: stays inside int32 below 2^16
+        for (i = 0; i < nTaps; i++)
+        {
+            absSum += (uint32_t)((taps[i] < 0) ? -(int32_t)taps[i] : taps[i]);
+        }
+        if (absSum >= 65536UL)
+        {
+            return false;
+        }
+    }
+    else
+    {
+        nTaps = 0;
+        firRatio = 1;
+    }
+
+    d->inSigned = inSigned;
+    d->cicOrder = cicOrder;
+    d->cicRatio = cicRatio;
+    d->cicMul   = (uint32_t)((0x80000000UL + gain / 2U) / gain);
+    d->taps     = taps;
+    d->nTaps    = nTaps;
+    d->firRatio = firRatio;
+    decim_reset(d);
+    return true;
+}
+
+void decim_reset(Decim *d)
+{
+    uint16_t i;
+
+    for (i = 0; i < DECIM_CIC_MAX_ORDER; i++)
+    {
+        d->integ[i] = 0;
+        d->comb[i]  = 0;
+    }
+    for (i = 0; i < 2U * DECIM_FIR_MAX_TAPS; i++)
+    {
+        d->line[i] = 0;
+    }
+    d->cicCount   = 0;
+    d->firCount   = 0;
+    d->pos        = 0;
+    d->inSamples  = 0;
+    d->outSamples = 0;
+}
+
+//---------------------------------------------------------------------------
+// CIC: N integrators at the input rate, N combs at the output rate.
+// Returns true when x has been replaced by an output sample.
+//---------------------------------------------------------------------------
+static inline bool cicStep(Decim *d, int16_t *x)
+{
+    uint32_t v = (uint32_t)(int32_t)*x;
+    uint16_t k;
+
+    // Integrators wrap modulo 2^32; the combs undo the wrap exactly.
+    for (k = 0; k < d->cicOrder; k++)
+    {
+        d->integ[k] += v;
+        v = d->integ[k];
+    }
+    if (++d->cicCount < d->cicRatio)
+    {
+        return false;
+    }
+    d->cicCount = 0;
+
+    for (k = 0; k < d->cicOrder; k++)
+    {
+        uint32_t prev = d->comb[k];
+
+        d->comb[k] = v;
+        v -= prev;
+    }
+
+    // Divide the gain R^N out (Q31 multiply, once per CIC output)
+    *x = (int16_t)(((int64_t)(int32_t)v * (int64_t)d->cicMul) >> 31);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Decimating FIR: every input enters the delay line, one dot product per
+// firRatio inputs. Returns true when x has been replaced by an output.
+//---------------------------------------------------------------------------
+static inline bool firStep(Decim *d, int16_t *x)
+{
+    const int16_t *h = d->taps;
+    const int16_t *w;
+    int32_t acc;
+    uint16_t n = d->nTaps;
+    uint16_t k;
+
+    // Newest sample at line[pos], written twice so the window
+    // line[pos .. pos + n - 1] never wraps.
+    d->pos = (d->pos == 0U) ? (uint16_t)(n - 1U) : (uint16_t)(d->pos - 1U);
+    d->line[d->pos]     = *x;
+    d->line[d->pos + n] = *x;
+
+    if (++d->firCount < d->firRatio)
+    {
+        return false;
+    }
+    d->firCount = 0;
+
+    w = &d->line[d->pos];
+    acc = 0x4000;                           // Round
+    for (k = 0; k < n; k++)
+    {
+        acc += (int32_t)h[k] * w[k];
+    }
+    acc >>= 15;
+    if (acc > 32767)
+    {
+        acc = 32767;
+    }
+    else if (acc < -32768)
+    {
+        acc = -32768;
+    }
+    *x = (int16_t)acc;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Block processing
+//---------------------------------------------------------------------------
+uint16_t decim_process(Decim *d, const uint16_t *in, uint16_t stride,
+                       uint16_t n, uint16_t *out)
+{
+    uint32_t t0 = CPUTimer_getTimerCount(DECIM_TIMESTAMP_BASE);
+    uint16_t bias = d->inSigned ? 0U : 0x8000U;
+    uint16_t produced = 0;
+    uint16_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        // Offset binary -> two's complement for unsigned captures
+        int16_t x = (int16_t)(*in ^ bias);
+
+        in += stride;
+        if ((d->cicOrder != 0U) && !cicStep(d, &x))
+        {
+            continue;
+        }
+        if ((d->taps != NULL) && !firStep(d, &x))
+        {
+            continue;
+        }
+        out[produced++] = (uint16_t)x ^ bias;
+    }
+
+    d->inSamples  += n;
+    d->outSamples += produced;
+
+    // The timer counts down
+    d->blockCycles = t0 - CPUTimer_getTimerCount(DECIM_TIMESTAMP_BASE);
+    if (n != 0U)
+    {
+        d->cyclesPerInput = (float32_t)d->blockCycles / (float32_t)n;
+    }
+    return produced;
+}
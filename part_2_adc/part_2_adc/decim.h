@@ -0,0 +1,103 @@
+//#############################################################################
+// File: decim.h
+// Chapter: ADC
+// Code description: fixed-point multi-stage decimator for captured ADC
+// blocks, one Decim per channel. An optional CIC front end (order 1..4,
+// ratio R) removes most of the rate cheaply, and a decimating FIR with Q15
+// taps either compensates the CIC droop and decimates the rest (typically
+// by 2), or on its own does small ratios as a polyphase filter: only the
+// outputs that are kept are computed, so the cost per input sample is
+// taps / ratio multiply-adds.
+//
+// Samples keep the capture format: unsigned codes in, unsigned codes out
+// (internally offset by 0x8000), or int16_t in and out for differential
+// captures. The FIR gain is 1 at DC, the CIC gain R^N is divided out.
+//#############################################################################
+
+#ifndef DECIM_H
+#define DECIM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define DECIM_CIC_MAX_ORDER     4U
+#define DECIM_CIC_MAX_GAIN      65536UL     // R^N: keeps 16-bit input in 32 bits
+#define DECIM_FIR_MAX_TAPS      80U
+
+// Cost figures use this free-running down-counter (started by adc_acq)
+#define DECIM_TIMESTAMP_BASE    CPUTIMER1_BASE
+
+// Built-in filters (Q15, DC gain 1), checked by tools/decim_taps_check.py
+#define DECIM_LOWPASS5_TAPS     75U     // Decimate by 5, e.g. 40 kHz -> 8 kHz:
+                                        // flat to 0.075 fs, -54 dB from 0.125 fs
+#define DECIM_CIC3_COMP_TAPS    47U     // After an order-3 CIC (R >= 8),
+                                        // decimate by 2: droop flat to 0.15 fs,
+                                        // -59 dB from 0.32 fs (fs = CIC output)
+
+extern const int16_t decimLowpass5[DECIM_LOWPASS5_TAPS];
+extern const int16_t decimCic3Comp[DECIM_CIC3_COMP_TAPS];
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    bool     inSigned;                  // int16_t samples (differential)
+
+    // CIC stage (order 0 = bypass)
+    uint16_t cicOrder;
+    uint16_t cicRatio;
+    uint16_t cicCount;
+    uint32_t cicMul;                    // 2^31 / R^N
+    uint32_t integ[DECIM_CIC_MAX_ORDER];    // Modulo 2^32 arithmetic
+    uint32_t comb[DECIM_CIC_MAX_ORDER];
+
+    // FIR stage (taps = NULL: bypass)
+    const int16_t *taps;
+    uint16_t nTaps;
+    uint16_t firRatio;
+    uint16_t firCount;
+    uint16_t pos;
+    int16_t  line[2U * DECIM_FIR_MAX_TAPS]; // Delay line, stored twice
+
+    // Statistics
+    uint32_t inSamples;
+    uint32_t outSamples;
+    uint32_t blockCycles;               // SYSCLK of the last decim_process()
+    float32_t cyclesPerInput;           // blockCycles / inputs of that call
+} Decim;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Total ratio = cicRatio * firRatio. cicOrder 0 bypasses the CIC (cicRatio
+// is then ignored); taps NULL bypasses the FIR. Returns false if R^N is
+// above DECIM_CIC_MAX_GAIN, nTaps above DECIM_FIR_MAX_TAPS, or the taps'
+// absolute sum could overflow the 32-bit accumulator (>= 2.0 in Q15).
+bool decim_init(Decim *d, uint16_t cicOrder, uint16_t cicRatio,
+                const int16_t *taps, uint16_t nTaps, uint16_t firRatio,
+                bool inSigned);
+
+// Clear the filter state (not the configuration).
+void decim_reset(Decim *d);
+
+// Consume n input samples in[0], in[stride], ... (one channel of a planar
+// or interleaved block) and write the decimated samples to out. Returns the
+// number written, at most n / (cicRatio * firRatio) + 1.
+uint16_t decim_process(Decim *d, const uint16_t *in, uint16_t stride,
+                       uint16_t n, uint16_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DECIM_H
@@ -0,0 +1,63 @@
+//#############################################################################
+// File: isr_nest.c
+// Chapter: Interrupts
+// Code description: nesting masks from software priorities. See isr_nest.h.
+//#############################################################################
+
+#include "isr_nest.h"
+
+//---------------------------------------------------------------------------
+// INT_xxx fields (as decoded by interrupt.c)
+//---------------------------------------------------------------------------
+static inline uint16_t groupOf(uint32_t intNumber)
+{
+    return (uint16_t)((intNumber & 0xFF00U) >> 8);
+}
+
+static inline uint16_t channelOf(uint32_t intNumber)
+{
+    return (uint16_t)(intNumber & 0xFFU);
+}
+
+// IER line: PIE group n on INTn, INT13/INT14 (CPU timers 1, 2) by vector
+static inline uint16_t ierBitOf(uint32_t intNumber)
+{
+    uint16_t group = groupOf(intNumber);
+    uint16_t line = (group != 0U) ? group : (uint16_t)(intNumber >> 16);
+
+    return 1U << (line - 1U);
+}
+
+//---------------------------------------------------------------------------
+// Masks
+//---------------------------------------------------------------------------
+void isr_nest_init(IsrNest_Entry *table, uint16_t count)
+{
+    uint16_t i;
+    uint16_t j;
+
+    for (i = 0; i < count; i++)
+    {
+        IsrNest_Entry *e = &table[i];
+
+        e->group  = groupOf(e->intNumber);
+        e->ier    = 0;
+        e->ownIer = ierBitOf(e->intNumber);
+        e->pieier = 0;
+
+        for (j = 0; j < count; j++)
+        {
+            const IsrNest_Entry *o = &table[j];
+
+            if (o->priority <= e->priority)
+            {
+                continue;
+            }
+            e->ier |= ierBitOf(o->intNumber);
+            if ((e->group != 0U) && (groupOf(o->intNumber) == e->group))
+            {
+                e->pieier |= 1U << (channelOf(o->intNumber) - 1U);
+            }
+        }
+    }
+}
@@ -0,0 +1,117 @@
+//#############################################################################
+// File: isr_nest.h
+// Chapter: Interrupts
+// Code description: software interrupt priorities with nesting. The C28x
+// services interrupts one at a time (INTM is set on entry), so a long
+// handler delays every other one, whatever its urgency. Here each handler
+// is given a priority in a table; isr_nest_init() works out, per handler,
+// which CPU interrupt lines (IER) and which members of its own PIE group
+// (PIEIER) belong to higher priorities. A handler bracketed by
+// ISR_NEST_ENTER / ISR_NEST_EXIT then runs with interrupts re-enabled but
+// only those higher ones unmasked, following TI's nesting recipe:
+//  - save IER and the group's PIEIER, load the masks; the own INTx line
+//    (cleared by the CPU on entry) is turned back on when a higher priority
+//    member of the same PIE group exists, PIEIER then lets only those in
+//  - acknowledge the own PIE group, wait a cycle for PIEIER to settle, EINT
+//  - on the way out: DINT, restore PIEIER and IER
+//
+// Only the handler's own PIE group is filtered member by member. For any
+// other group holding a higher priority entry the whole INTx line is
+// opened, so every enabled source of that group can preempt, in the table
+// or not and whatever its priority (e.g. another group 1 source while
+// epwm1TzISR runs nested behind INT_ADCA1). Changing another group's
+// PIEIER from here would need TI's disable sequence (DINT, clear, wait,
+// clear PIEIFR) on every entry, so keep such groups free of other enabled
+// sources. Interrupts on lines without a higher entry never preempt.
+// The top priority handler does not need the macros (nothing may preempt
+// it). A nested handler's stack use adds up with its preemptor's.
+//
+// Build with ISR_NEST_ENABLE = 0 (project predefined symbol) to keep all
+// handlers non-nested; the macros then only open and close a block.
+//#############################################################################
+
+#ifndef ISR_NEST_H
+#define ISR_NEST_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#ifndef ISR_NEST_ENABLE
+#define ISR_NEST_ENABLE         1
+#endif
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t intNumber;             // INT_xxx (hw_ints.h)
+    uint16_t priority;              // Higher preempts lower, equal does not
+
+    // Computed by isr_nest_init()
+    uint16_t group;                 // PIE group 1..12, 0 for INT13/INT14
+    uint16_t ier;                   // IER lines left enabled while nested
+                                    // (own line only if a same-group
+                                    // member has higher priority; other
+                                    // groups' lines open to all members)
+    uint16_t ownIer;                // Own INTx line
+    uint16_t pieier;                // Own PIEIER bits left enabled
+} IsrNest_Entry;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Compute the masks of every entry of table
+void isr_nest_init(IsrNest_Entry *table, uint16_t count);
+
+#if ISR_NEST_ENABLE
+
+// Opens a block that ISR_NEST_EXIT() closes, in the same function
+#define ISR_NEST_ENTER(e)                                                   \
+    {                                                                       \
+        const IsrNest_Entry *isrNestEntry = (e);                            \
+        uint32_t isrNestPie = PIECTRL_BASE + PIE_O_IER1 +                   \
+                              2U * (isrNestEntry->group - 1U);              \
+        uint16_t isrNestIer = IER;                                          \
+        uint16_t isrNestPieier = 0;                                         \
+                                                                            \
+        IER = (isrNestIer | isrNestEntry->ownIer) & isrNestEntry->ier;      \
+        if (isrNestEntry->group != 0U)                                      \
+        {                                                                   \
+            isrNestPieier = HWREGH(isrNestPie);                             \
+            HWREGH(isrNestPie) = isrNestPieier & isrNestEntry->pieier;      \
+            Interrupt_clearACKGroup(1U << (isrNestEntry->group - 1U));      \
+        }                                                                   \
+        asm(" NOP");                                                        \
+        EINT;
+
+#define ISR_NEST_EXIT()                                                     \
+        DINT;                                                               \
+        if (isrNestEntry->group != 0U)                                      \
+        {                                                                   \
+            HWREGH(isrNestPie) = isrNestPieier;                             \
+        }                                                                   \
+        IER = isrNestIer;                                                   \
+    }
+
+#else
+
+#define ISR_NEST_ENTER(e)       {
+#define ISR_NEST_EXIT()         }
+
+#endif // ISR_NEST_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ISR_NEST_H
@@ -0,0 +1,118 @@
+//#############################################################################
+// File: isr_prof.c
+// Chapter: Interrupts
+// Code description: ISR latency / execution-time accumulation. See
+// isr_prof.h.
+//#############################################################################
+
+#include <string.h>
+#include "isr_prof.h"
+
+#if ISR_PROF_ENABLE
+
+//---------------------------------------------------------------------------
+// Globals
+//---------------------------------------------------------------------------
+IsrProf_Block isrProf;
+
+//---------------------------------------------------------------------------
+// Helpers
+//---------------------------------------------------------------------------
+// floor(log2(x)) in four steps; 2^16 and up go to the last bucket
+static inline uint16_t bucketOf(uint32_t x)
+{
+    uint16_t b = 0;
+
+    if (x >= 0x10000UL)
+    {
+        return ISR_PROF_BUCKETS - 1U;
+    }
+    if (x >= 0x100UL)
+    {
+        x >>= 8;
+        b += 8U;
+    }
+    if (x >= 0x10UL)
+    {
+        x >>= 4;
+        b += 4U;
+    }
+    if (x >= 0x4UL)
+    {
+        x >>= 2;
+        b += 2U;
+    }
+    if (x >= 0x2UL)
+    {
+        b += 1U;
+    }
+    return b;
+}
+
+static void clearStat(IsrProf_Stat *s)
+{
+    memset(s, 0, sizeof(*s));
+    s->minCycles = 0xFFFFFFFFUL;
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+void isr_prof_init(uint32_t timerBase)
+{
+    isrProf.magic     = ISR_PROF_MAGIC;
+    isrProf.version   = ISR_PROF_VERSION;
+    isrProf.slots     = ISR_PROF_SLOTS;
+    isrProf.buckets   = ISR_PROF_BUCKETS;
+    isrProf.timerBase = timerBase;
+    isr_prof_reset(ISR_PROF_SLOTS);
+}
+
+void isr_prof_reset(uint16_t id)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+    uint16_t i;
+
+    for (i = 0; i < ISR_PROF_SLOTS; i++)
+    {
+        if ((id == i) || (id == ISR_PROF_SLOTS))
+        {
+            clearStat(&isrProf.slot[i].latency);
+            clearStat(&isrProf.slot[i].exec);
+        }
+    }
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
+
+//---------------------------------------------------------------------------
+// Accumulate (interrupt context)
+//---------------------------------------------------------------------------
+void isr_prof_record(IsrProf_Stat *s, uint32_t cycles)
+{
+    s->count++;
+    s->sumCycles += cycles;
+    if (cycles < s->minCycles)
+    {
+        s->minCycles = cycles;
+    }
+    if (cycles > s->maxCycles)
+    {
+        s->maxCycles = cycles;
+    }
+    s->hist[bucketOf(cycles)]++;
+}
+
+float32_t isr_prof_mean(const IsrProf_Stat *s)
+{
+    if (s->count == 0U)
+    {
+        return 0.0f;
+    }
+    return (float32_t)s->sumCycles / (float32_t)s->count;
+}
+
+#endif // ISR_PROF_ENABLE
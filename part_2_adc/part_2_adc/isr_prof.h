@@ -0,0 +1,147 @@
+//#############################################################################
+// File: isr_prof.h
+// Chapter: Interrupts
+// Code description: ISR latency and execution-time statistics. Each
+// instrumented ISR gets a slot in one fixed RAM block ("isrProf"), readable
+// from the Expressions window or a memory dump. ISR_PROF_ENTER() at the top
+// of the handler stamps the entry from a free-running CPU timer and records
+// the latency, i.e. how long ago the trigger fired (worked out by the caller
+// from the trigger source, see the helpers below); ISR_PROF_EXIT() at the
+// bottom records the execution time. Both feed min/max/mean and a log2
+// histogram: bucket 0 holds 0..1 cycles, bucket k holds 2^k..2^(k+1)-1,
+// the last one everything above.
+//
+// The execution time includes any nested interrupt that ran meanwhile.
+//
+// Build with ISR_PROF_ENABLE = 0 (project predefined symbol) for release:
+// the macros expand to nothing and the block is not allocated.
+//#############################################################################
+
+#ifndef ISR_PROF_H
+#define ISR_PROF_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#ifndef ISR_PROF_ENABLE
+#define ISR_PROF_ENABLE         1
+#endif
+
+// Marks the start of the block in a raw memory dump ("IP")
+#define ISR_PROF_MAGIC          0x4950U
+#define ISR_PROF_VERSION        1U
+#define ISR_PROF_SLOTS          6U
+#define ISR_PROF_BUCKETS        16U     // Up to 32768+ cycles
+#define ISR_PROF_NO_AGE         0xFFFFFFFFUL    // Trigger time unknown
+
+//---------------------------------------------------------------------------
+// Trigger age helpers (SYSCLK cycles since the trigger)
+//---------------------------------------------------------------------------
+// CPU timer interrupt or TINT-triggered DMA/ADC: the counter reloads from
+// PRD when it reaches zero, which is the trigger
+#define ISR_PROF_TIMER_AGE(base) \
+    (HWREG((base) + CPUTIMER_O_PRD) - HWREG((base) + CPUTIMER_O_TIM))
+
+// Up-count ePWM event at TBCTR = cmp (e.g. SOCA on CMPC), sysclkPerTbclk
+// SYSCLK per TBCLK; valid when the ISR starts within one period
+static inline uint32_t isr_prof_epwmAge(uint32_t base, uint16_t cmp,
+                                        uint16_t sysclkPerTbclk)
+{
+    uint16_t ctr = EPWM_getTimeBaseCounterValue(base);
+    uint32_t ticks = (ctr >= cmp) ? (uint32_t)(ctr - cmp) :
+                     (uint32_t)ctr + EPWM_getTimeBasePeriod(base) + 1UL - cmp;
+
+    return ticks * sysclkPerTbclk;
+}
+
+#if ISR_PROF_ENABLE
+
+//---------------------------------------------------------------------------
+// Statistics block
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t count;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t sumCycles;             // mean = sumCycles / count
+    uint32_t hist[ISR_PROF_BUCKETS];
+} IsrProf_Stat;
+
+typedef struct
+{
+    uint32_t     entry;             // Timer count at the last entry
+    IsrProf_Stat latency;           // Trigger -> ISR_PROF_ENTER()
+    IsrProf_Stat exec;              // ISR_PROF_ENTER() -> ISR_PROF_EXIT()
+} IsrProf_Slot;
+
+typedef struct
+{
+    uint16_t     magic;             // ISR_PROF_MAGIC
+    uint16_t     version;           // ISR_PROF_VERSION
+    uint16_t     slots;
+    uint16_t     buckets;
+    uint32_t     timerBase;         // Free-running, counts down at SYSCLK
+    IsrProf_Slot slot[ISR_PROF_SLOTS];
+} IsrProf_Block;
+
+extern IsrProf_Block isrProf;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Clear the block and use timerBase for the stamps. The timer must already
+// be free-running (period 0xFFFFFFFF, SYSCLK), as set up by its owner:
+// dma_chain_init() in part_1_dma, adc_acq_startTimestamp() in part_2_adc.
+void isr_prof_init(uint32_t timerBase);
+
+// Clear the statistics of one slot, or of all with ISR_PROF_SLOTS
+void isr_prof_reset(uint16_t id);
+
+void isr_prof_record(IsrProf_Stat *s, uint32_t cycles);
+
+// Mean in cycles, 0 before the first sample
+float32_t isr_prof_mean(const IsrProf_Stat *s);
+
+static inline void isr_prof_enter(uint16_t id, uint32_t age)
+{
+    isrProf.slot[id].entry = HWREG(isrProf.timerBase + CPUTIMER_O_TIM);
+    if (age != ISR_PROF_NO_AGE)
+    {
+        isr_prof_record(&isrProf.slot[id].latency, age);
+    }
+}
+
+static inline void isr_prof_exit(uint16_t id)
+{
+    // The timer counts down
+    isr_prof_record(&isrProf.slot[id].exec, isrProf.slot[id].entry -
+                    HWREG(isrProf.timerBase + CPUTIMER_O_TIM));
+}
+
+#define ISR_PROF_INIT(timerBase)    isr_prof_init(timerBase)
+#define ISR_PROF_ENTER(id, age)     isr_prof_enter((id), (age))
+#define ISR_PROF_EXIT(id)           isr_prof_exit(id)
+
+#else
+
+#define ISR_PROF_INIT(timerBase)
+#define ISR_PROF_ENTER(id, age)
+#define ISR_PROF_EXIT(id)
+
+#endif // ISR_PROF_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ISR_PROF_H
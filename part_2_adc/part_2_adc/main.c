@@ -11,34 +11,315 @@ Description: ePWM-ADC loopback example with a PWM frequency of 1khz and sampling
 #include "device.h"
 #include "sysctl.h"
 #include "Myboard.h"
+#include "buf_pool.h"
+#include "rate_gen.h"
+#include "adc_scale.h"
+#include "sample_clock.h"
+#include "adc_acq.h"
+#include "adc_monitor.h"
+#include "decim.h"
+#include "adc_cal.h"
+#include "adc_tune.h"
+#include "pwm_wave.h"
+#include "pwm_timing.h"
+#include "pwm_hr.h"
+#include "pwm_group.h"
+#include "pwm_trip.h"
+#include "isr_prof.h"
+#include "region_prof.h"
+#include "isr_nest.h"
+#include "clk_mon.h"
+#include "crc_mon.h"
 
 // Macros
-#define ADC_BUF_LEN  250
+#define ADC_BUF_LEN  250 // frames (samples per channel) per block
+#define ADC_CHANNELS 4   // inputs in adcInputs[], sampled simultaneously on every trigger
+#define ADC_PLANAR   1   // 1 = one contiguous run per channel, 0 = interleaved channel vectors
+#define ADC_OSR      4   // SOCs summed per sample (1, 2, 4, 8 or 16); 4 keeps one PPB per SOC
+#define ADC_BLOCKS   4  // blocks of ADC_BUF_LEN samples rotated through by the ISR
 #define PWM_FREQ 1000
-#define SAMPLING_FREQ 40e3
-#define ADC_ACQPS_TICKS 14
-#define TBCLK 100e6 // 200mhz / 2 (default divider value, reference: https://dev.ti.com/tirex/explore/node?node=A__ASXXwGbQ.ubt5o3S3jXEvA__C28X-ACADEMY__1sbHxUB__LATEST)
-#define TBCLK_DIVIDER 4
+#define SAMPLING_FREQ 40000UL
+#define DECIM_RATIO 5    // SAMPLING_FREQ -> 8 kHz for the analysis code
+
+// ADC mode: 1 = 16-bit differential (inputs are ADCINx+/ADCINx+1- pairs, signed samples),
+// 0 = 12-bit single-ended (unsigned samples)
+#define ADC_DIFF16 0
+#if ADC_DIFF16
+#define ADC_CFG_RESOLUTION ADC_RESOLUTION_16BIT
+#define ADC_CFG_SIGNAL_MODE ADC_MODE_DIFFERENTIAL
+#define ADC_ACQPS_TICKS 63  // 320 ns S+H minimum for 16-bit
+#define ADC_MV_PER_CODE (1000.0f * ADC_SCALE_DIFF16_VOLTS_PER_CODE)  // -3000->3000 mV
+#define ADC_MID_MV 0.0f
+#else
+#define ADC_CFG_RESOLUTION ADC_RESOLUTION_12BIT
+#define ADC_CFG_SIGNAL_MODE ADC_MODE_SINGLE_ENDED
+#define ADC_ACQPS_TICKS 14  // 75 ns S+H minimum for 12-bit
+#define ADC_MV_PER_CODE (1000.0f * ADC_SCALE_SE12_VOLTS_PER_CODE)   // 0->3000 mV
+#define ADC_MID_MV 1500.0f
+#endif
+#define ADC_CFG_PRESCALE ADC_CLK_DIV_4_0  // ADCCLK = 200 MHz / 4 = 50 MHz (maximum)
+
+// S+H window / ADC clock autotuning against the source actually connected: ADC_AUTOTUNE 1 sweeps
+// them at startup on ADCB ADCIN2 (ADCIN4 tied to GND as precharge input). Save adcTune.header from
+// the debugger as adc_tuned.h and build with ADC_USE_TUNED 1 to use the result.
+#define ADC_AUTOTUNE 0
+#define ADC_TUNE_MAX_ERROR_LSB 0.5f
+#define ADC_USE_TUNED 0
+#if ADC_USE_TUNED
+#include "adc_tuned.h"
+#undef ADC_ACQPS_TICKS
+#define ADC_ACQPS_TICKS ADC_TUNED_ACQPS
+#undef ADC_CFG_PRESCALE
+#define ADC_CFG_PRESCALE ADC_TUNED_PRESCALE
+#endif
+#define ADC_MV_TO_CODE(mv) ((int32_t)((mv) / ADC_MV_PER_CODE + 0.5f)) // single-conversion code
+
+// Hardware limit monitoring (PPB events, CPU interrupted only on a violation)
+#define ADC_MON_HI_MV 2800.0f   // channel 1 window, latched until adc_monitor_rearm()
+#define ADC_MON_LO_MV 200.0f
+
+// Noise / ENOB report (adcReport): needs a channel with a clean DC input (e.g. a divider on the
+// 3V3 rail with a capacitor), not channel 0, which carries the ePWM1A loopback waveform
+#define ADC_REPORT_CHANNEL 3    // ADCD ADCIN0
+#if ADC_REPORT_CHANNEL >= ADC_CHANNELS
+#error "ADC_REPORT_CHANNEL is not in adcInputs[]"
+#endif
+
+// Per-channel calibration: segments of the piecewise-linear correction (1 = offset/gain only)
+#define ADC_CAL_SEGMENTS 8
+
+// PWM timing, computed at compile time (pwm_timing.h): EPWMCLK = 200 MHz / 2 (default divider value,
+// reference: https://dev.ti.com/tirex/explore/node?node=A__ASXXwGbQ.ubt5o3S3jXEvA__C28X-ACADEMY__1sbHxUB__LATEST)
+// divided by the smallest prescaler that fits the period in 16 bits (1 kHz: /1, TBPRD = 50000, 10 ns steps)
+#define PWM_DUTY_PERMILLE 250   // 25%
+#define PWM_DEADBAND_NS 0       // > 0: ePWM1B = complement of ePWM1A with this rising/falling dead band
+#define PWM_CLKDIV_LOG2 PWM_TIMING_CLKDIV_LOG2(PWM_FREQ)
+#define TBCLK PWM_TIMING_TBCLK_HZ(PWM_FREQ)
+#define PWM_TBPRD PWM_TIMING_TBPRD(PWM_FREQ)
+#define PWM_CMPA PWM_TIMING_CMP(PWM_TBPRD, PWM_DUTY_PERMILLE)
+#define PWM_DB_COUNTS PWM_TIMING_DB_COUNTS(PWM_DEADBAND_NS, TBCLK)
+#if PWM_CLKDIV_LOG2 > PWM_TIMING_MAX_CLKDIV_LOG2
+#error "PWM_FREQ too low: the period does not fit 16 bits even with TBCLK divided by 128"
+#endif
+#if PWM_TBPRD < PWM_TIMING_MIN_TBPRD
+#error "PWM_FREQ too high for EPWMCLK"
+#endif
+#if PWM_DUTY_PERMILLE > 1000
+#error "PWM_DUTY_PERMILLE above 1000"
+#endif
+#if PWM_DB_COUNTS > PWM_TIMING_MAX_DB
+#error "PWM_DEADBAND_NS above the 14-bit dead-band counter"
+#endif
+
+// PWM modulation: 0 = fixed PWM_DUTY_PERMILLE duty (the loopback example), 1 = sine (SPWM) streamed
+// into CMPA by DMA from ePWM1 SOCA (changes what channel 0 and its zero-crossing count see)
+#define PWM_WAVE 0
+#define PWM_WAVE_FREQ 50.0f     // Waveform frequency, PWM_FREQ / PWM_WAVE_FREQ table entries
+#define PWM_WAVE_AMPLITUDE 0.8f // Modulation index
+#define PWM_WAVE_MAX_LEN 200    // Table entries (lowest frequency PWM_FREQ / PWM_WAVE_MAX_LEN)
+
+// High-resolution duty on ePWM1A (HRPWM MEP, ~150 ps steps instead of 1 TBCLK). The MEP step is
+// calibrated with ePWM3A (GPIO4, leave unconnected) timed by eCAP1, and again every
+// PWM_HR_RECAL_BLOCKS blocks to follow temperature. Duty is then set with pwm_hr_setDuty(&pwm1, d)
+#define PWM_HR 0
+#define PWM_HR_RECAL_BLOCKS 160 // ~1 s of blocks
+#if PWM_HR && PWM_WAVE
+#error "PWM_WAVE streams coarse CMPA values only: use one of PWM_HR and PWM_WAVE"
+#endif
+#if PWM_HR && (PWM_CLKDIV_LOG2 != 0)
+#error "HRPWM needs TBCLK = EPWMCLK: PWM_FREQ too low for an undivided time base"
+#endif
+
+// Multi-phase group: ePWM4A/7A/10A (GPIO6/12/18) on ePWM1's period, interleaved by 1/PWM_GROUP_PHASES
+// of a cycle at PWM_DUTY_PERMILLE. Duty/phase sets are applied together on the next PWM cycle
+// (global load, no ISR): from the debugger, edit pwmGroupDuty[]/pwmGroupPhase[] and set pwmGroupCommit
+#define PWM_GROUP 0
+#define PWM_GROUP_PHASES 3      // 1..3 (pwmGroupBases[])
+#if PWM_GROUP && ((PWM_GROUP_PHASES < 1) || (PWM_GROUP_PHASES > 3))
+#error "PWM_GROUP_PHASES outside the 3 ePWMs synced from ePWM1 by SYNC_init()"
+#endif
+
+// Overcurrent trip in hardware: CMPSS3 on channel 1's pin (ADCINB2) above PWM_TRIP_MV -> ePWM X-BAR
+// TRIP4 -> one-shot trip zone, ePWM1 (and the group) A/B forced low without the CPU. The ePWM1 trip
+// interrupt latches telemetry in pwmTrip; set pwmTripRearm from the debugger to release the outputs
+#define PWM_TRIP 0
+#define PWM_TRIP_MV ADC_MON_HI_MV   // Same level as the channel 1 window (which only reports)
+#define PWM_TRIP_VDDA_MV 3300.0f    // CMPSS DAC reference
+#define PWM_TRIP_FILTER_WINDOW 3    // SYSCLK samples (2 must agree), 0 = unfiltered
+
+// ISR latency / execution-time slots in isrProf.slot[] (isr_prof.h). Build with the predefined
+// symbol ISR_PROF_ENABLE=0 to compile the instrumentation out
+#define ISR_ID_ADC 0            // adcA1ISR, latency from the trigger (conversions included)
+#define ISR_ID_PWM_WAVE 1       // dmaCh6ISR
+#define ISR_ID_PWM_TRIP 2       // epwm1TzISR
+
+// Code-region cycle counts in regionProf (region_prof.h), one row per function with
+// part_2_adc/tools/region_prof_report.py. Build with REGION_PROF_ENABLE=0 to compile them out
+#define REGION_ADC_ISR 0        // adcA1ISR body
+#define REGION_SCALE 1          // adc_cal_apply over the block
+#define REGION_REPORT 2         // adc_acq_report
+#define REGION_DECIM 3          // decim_process over the block
+
+// Interrupt priorities (isr_nest.h), higher preempts lower: adcA1ISR never waits for the slower
+// handlers, which run nested. Compare isrProf.slot[ISR_ID_ADC].latency with ISR_NEST_ENABLE=0
+#define NEST_ADC 0
+#define NEST_PWM_WAVE 1
+#define NEST_PWM_TRIP 2
+
+// SYSCLK check against the crystal (clk_mon.h): CPU Timer 2 counts XTAL, CPU Timer 1 SYSCLK. Checked
+// once after the PLL is set (ESTOP0 if off), then one window every CLK_MON_WINDOW_US in the main loop
+#define CLK_MON 1
+#define CLK_MON_WINDOW_US 100000UL  // 1 crystal tick = 1 ppm with a 10 MHz crystal
+#define CLK_MON_TOL_PPM 500.0f      // Beyond this SYSCLK is faulty (clkMon.faults)
+#define CLK_MON_CORRECT_PPM 5.0f    // Retune the CPU Timer 0 sample rate beyond this (timer trigger only)
+
+// Background CRC-32 of the tables that must not change (crc_mon.h), learned on the first pass and
+// checked CRC_MON_SLICE_WORDS words per idle pass of the main loop: crcMon.mismatches, .firstBad
+#define CRC_MON 1
+#define CRC_MON_REGIONS 8
+#define CRC_MON_SLICE_WORDS 64      // Bounds one idle step to a few thousand cycles
+
+// ADC trigger source: 1 = ePWM2 SOCA phase-locked to the ePWM1 PWM (CPU Timer 0 unused),
+// 0 = free-running CPU Timer 0
+#define ADC_TRIGGER_EPWM 1
+#define SAMPLE_POINT_TBCLK 0    // Sampling point inside each sample slot, in TBCLK
+#if ADC_TRIGGER_EPWM && ((2UL * PWM_TBPRD) % (SAMPLING_FREQ / PWM_FREQ) != 0)
+#error "PWM cycle (2 * PWM_TBPRD) is not a whole number of sample slots"
+#endif
 
 
 // Variables
-uint16_t rawData[ADC_BUF_LEN];
-float32_t measuredVals[ADC_BUF_LEN];
-uint16_t adcBufferIndex = 0;    // Current index for ADC data buffer
-uint32_t sysClockFreq = 0;
+uint16_t rawData[ADC_BLOCKS * ADC_CHANNELS * ADC_BUF_LEN];   // Raw codes only, scaled by the consumer
+int16_t measuredMv[ADC_CHANNELS * ADC_BUF_LEN];                 // Last processed block in millivolts, same layout
+AdcCal adcCal[ADC_CHANNELS];    // Per-channel code -> mV tables (ideal until calibrated)
+
+// Calibration from the debugger: apply a known voltage to channel calChannel, set calPointMv,
+// then calCommand = CAL_ADD_POINT (repeat for more points), then CAL_BUILD. Cleared when done.
+#define CAL_ADD_POINT 1
+#define CAL_BUILD 2
+#define CAL_CLEAR 3
+volatile uint16_t calCommand = 0;
+volatile uint16_t calChannel = 0;
+volatile float32_t calPointMv = 0.0f;
+uint16_t adcBufferIndex = 0;    // Current frame inside the block being filled (ISR only)
+
+// One input per ADC, all on the same trigger: channel c of every block is adcInputs[c]
+const AdcAcq_Input adcInputs[ADC_CHANNELS] =
+{
+    { ADCA_BASE, ADC_CH_ADCIN0 },   // ePWM1A loopback (A0/A1 pair when differential)
+    { ADCB_BASE, ADC_CH_ADCIN2 },
+    { ADCC_BASE, ADC_CH_ADCIN2 },
+    { ADCD_BASE, ADC_CH_ADCIN0 },   // DC input for adcReport (ADC_REPORT_CHANNEL)
+};
+AdcAcq adcAcq;                  // adcAcq.maxTriggerHz / aggregateSps: achievable rates for this table
+AdcAcq_Report adcReport;        // ADC_REPORT_CHANNEL noise, ENOB gain from ADC_OSR and ISR cycles per output sample
+                                // (adcReport.atFloor: spread below one stored LSB, not a measurement)
+
+// Indexed by NEST_xxx; adc_monitor's event interrupts are not listed, so they never preempt
+IsrNest_Entry isrNest[] =
+{
+    { INT_ADCA1, 3 },           // Set to adcAcq.intNumber at startup
+    { INT_DMA_CH6, 2 },
+    { INT_EPWM1_TZ, 1 },
+};
+
+#if ADC_AUTOTUNE
+const AdcTune_Config adcTuneCfg =
+{
+    ADCB_BASE, ADC_CH_ADCIN2, ADC_CH_ADCIN4, ADC_CFG_RESOLUTION, ADC_CFG_SIGNAL_MODE,
+    256, ADC_TUNE_MAX_ERROR_LSB, DEVICE_SYSCLK_FREQ
+};
+AdcTune adcTune;                // Sweep results in adcTune.point[], generated header in adcTune.header
+#endif
+
+// Per-channel decimation to SAMPLING_FREQ / DECIM_RATIO (adcDecim[c].cyclesPerInput: cost).
+// At higher capture rates use the CIC front end, e.g. 320 kHz -> 8 kHz:
+// decim_init(&adcDecim[c], 3, 20, decimCic3Comp, DECIM_CIC3_COMP_TAPS, 2, ADC_DIFF16)
+Decim adcDecim[ADC_CHANNELS];
+uint16_t decimated[ADC_CHANNELS][ADC_BUF_LEN / DECIM_RATIO];  // Last block, same code format as rawData
+
+// Filled blocks are handed to the main loop in place (no copy). Watch
+// adcPool.readyQ.highWater (deepest backlog) and adcPool.dropped (blocks lost)
+BufPool adcPool;
+BufDesc adcDesc[ADC_BLOCKS];
+BufDesc *adcBlock;              // Block the ISR is filling
+
+#if PWM_WAVE
+// Change at runtime with pwm_wave_set(&pwmWave, shape or NULL for sine, shape length, amplitude, Hz)
+uint16_t pwmWaveTables[2 * PWM_WAVE_MAX_LEN];  // .bss is in GS RAM: reachable by the DMA
+PwmWave pwmWave;
+#endif
+
+#if PWM_HR
+const PwmHr_CalConfig pwmHrCalCfg =
+{
+    EPWM3_BASE, GPIO_4_EPWM3A, 4, ECAP1_BASE, XBAR_INPUT7, DEVICE_SYSCLK_FREQ, TBCLK
+};
+PwmHr_Cal pwmHrCal;             // pwmHrCal.mepScale: MEP steps per TBCLK, pwmHrCal.stepPs: step size
+PwmHr pwm1;
+uint16_t pwmHrBlocks = 0;       // Blocks since the last calibration
+#endif
+
+#if PWM_GROUP
+const uint32_t pwmGroupBases[3] = { EPWM4_BASE, EPWM7_BASE, EPWM10_BASE };
+const uint32_t pwmGroupPins[3] = { GPIO_6_EPWM4A, GPIO_12_EPWM7A, GPIO_18_EPWM10A };
+PwmGroup pwmGroup;
+volatile float32_t pwmGroupDuty[PWM_GROUP_PHASES];     // 0..1
+volatile float32_t pwmGroupPhase[PWM_GROUP_PHASES];    // Lag behind ePWM1, 0..1 of a cycle
+volatile uint16_t pwmGroupCommit = 0;                  // 1 = apply, cleared when done
+#endif
+
+#if PWM_TRIP
+const PwmTrip_Config pwmTripCfg =
+{
+    CMPSS3_BASE, XBAR_TRIP4, XBAR_EPWM_MUX04_CMPSS3_CTRIPH, XBAR_MUX04, EPWM_DC_TRIP_TRIPIN4,
+    PWM_TRIP_VDDA_MV, 1, 0, PWM_TRIP_FILTER_WINDOW, PWM_TRIP_FILTER_WINDOW / 2 + 1
+};
+const uint32_t pwmTripBases[] =
+{
+    EPWM1_BASE,
+#if PWM_GROUP
+    EPWM4_BASE, EPWM7_BASE, EPWM10_BASE,
+#endif
+};
+PwmTrip pwmTrip;                // pwmTrip.tripped, .tripTime, .cmpssStatus...: first trip since rearm
+volatile uint16_t pwmTripRearm = 0;    // 1 = release the outputs, cleared when done (stays 1 while over)
+#endif
+
+uint32_t sysClockFreq = 0;      // Measured SYSCLK (CLK_MON), else nominal
+#if CLK_MON
+ClkMon clkMon;                  // clkMon.errorPpm, .worstPpm, .faults, .stalls
+#endif
+#if CRC_MON
+CrcMon_Region crcRegions[CRC_MON_REGIONS];     // Per region: passes, mismatches, lastCrc vs golden
+CrcMon crcMon;
+uint16_t crcCalRegion[ADC_CHANNELS];           // adcCal[c].table, relearned after each rebuild
+#endif
+RateGen sampleRate;             // CPU Timer 0 sampling rate, achieved rate in sampleRate.achievedHz
+SampleClock sampleClock;        // ePWM2 sampling rate, achieved rate in sampleClock.achievedHz
 
 // Function Prototypes
 __interrupt void adcA1ISR(void);
+__interrupt void dmaCh6ISR(void);
+__interrupt void epwm1TzISR(void);
 void initCPUTimers(void);
-void configCPUTimer(uint32_t, float, float);
 void configureADC(void);
-void configureADCSOC(void);
 void initEPWM(uint32_t base);
 
 
+// Crystal actually fitted: 10 MHz on the LAUNCHXL-F28379D. The project does not define _LAUNCHXL_F28379D,
+// so device.h assumes the controlCARD's 20 MHz (DEVICE_OSCSRC_FREQ) with its own PLL setting; only its
+// DEVICE_SYSCLK_FREQ (200 MHz) holds here, which the check below ties to MY_DEVICE_SETCLOCK_CFG
+#define XTAL_HZ 10000000UL
+#define XTAL_IMULT 20
+
+#if (XTAL_HZ * XTAL_IMULT) != DEVICE_SYSCLK_FREQ
+#error "XTAL_HZ * XTAL_IMULT must equal DEVICE_SYSCLK_FREQ"
+#endif
+
 #define MY_DEVICE_SETCLOCK_CFG \
     (SYSCTL_OSCSRC_XTAL |       /* Use external crystal oscillator */ \
-     SYSCTL_IMULT(20) |         /* Integer multiplier = 20 (e.g., 10 MHz * 20 = 200 MHz VCO) */ \
+     SYSCTL_IMULT(XTAL_IMULT) | /* Integer multiplier = 20 (10 MHz * 20 = 200 MHz VCO) */ \
      SYSCTL_FMULT_NONE |        /* No fractional multiplier */ \
      SYSCTL_SYSDIV(0) |         /* Divide-by-1 for SYSCLK = 200 MHz */ \
      SYSCTL_PLL_ENABLE)         /* Enable PLL */
@@ -58,46 +339,267 @@ void main(void){
 
     // TIMER
     initCPUTimers();  // Initialize the Device Peripheral timers
-    configCPUTimer(CPUTIMER0_BASE, DEVICE_SYSCLK_FREQ, SAMPLING_FREQ); // fs in hertz
+#if !ADC_TRIGGER_EPWM
+    // fs in hertz, exact integer period (no timer ISR here, so rounded to the nearest cycle instead of dithered)
+    if (!rate_gen_init(&sampleRate, CPUTIMER0_BASE, DEVICE_SYSCLK_FREQ, (uint32_t)SAMPLING_FREQ, 1, false))
+    {
+        ESTOP0; // SAMPLING_FREQ out of CPU Timer 0's range
+    }
     CPUTimer_enableInterrupt(CPUTIMER0_BASE); // interrupt to trigger ADC conversions
+#endif
 
     // ADC
-    configureADC();     // Configure ADCA (ADC0)
-    configureADCSOC();  // Configure SOC for ADCA
-    Interrupt_register(INT_ADCA1, &adcA1ISR);
-    Interrupt_enable(INT_ADCA1);
+#if ADC_AUTOTUNE
+    if (!adc_tune_run(&adcTune, &adcTuneCfg))
+    {
+        ESTOP0; // nothing met ADC_TUNE_MAX_ERROR_LSB: see adcTune.point[] (header holds the closest)
+    }
+#endif
+    configureADC();     // Configure ADCA..ADCD and their SOCs
+    ISR_PROF_INIT(CPUTIMER1_BASE);  // Shares the free-running timestamp timer started by adc_acq
+    REGION_PROF_INIT(CPUTIMER1_BASE, DEVICE_SYSCLK_FREQ);
+#if CLK_MON
+    // SYSCLK against the crystal now that the timestamp timer runs (instead of trusting the PLL delay)
+    clk_mon_init(&clkMon, CPUTIMER1_BASE, CPUTIMER2_BASE, XTAL_HZ, DEVICE_SYSCLK_FREQ,
+                 CLK_MON_WINDOW_US, CLK_MON_TOL_PPM);
+    if (!clk_mon_measure(&clkMon))
+    {
+        ESTOP0; // SYSCLK off nominal or crystal stopped: see clkMon.measuredHz, clkMon.stalls
+    }
+    sysClockFreq = clkMon.measuredHz;
+#else
+    sysClockFreq = DEVICE_SYSCLK_FREQ;
+#endif
+    REGION_PROF_REGISTER(REGION_ADC_ISR, REGION_PROF_ADDR(adcA1ISR));
+    REGION_PROF_REGISTER(REGION_SCALE, REGION_PROF_ADDR(adc_cal_apply));
+    REGION_PROF_REGISTER(REGION_REPORT, REGION_PROF_ADDR(adc_acq_report));
+    REGION_PROF_REGISTER(REGION_DECIM, REGION_PROF_ADDR(decim_process));
+    Interrupt_register(adcAcq.intNumber, &adcA1ISR);
+    Interrupt_enable(adcAcq.intNumber);
+
+    // Channel 0: count PWM edges as crossings of mid-scale; channel 1: out-of-window trips
+    adc_monitor_watch(&adcAcq, 0, ADC_MV_TO_CODE(ADC_MID_MV), 0x7FFF, -0x8000,
+                      ADC_EVT_ZERO, 0);
+    adc_monitor_watch(&adcAcq, 1, ADC_MV_TO_CODE(ADC_MID_MV),
+                      ADC_MV_TO_CODE(ADC_MON_HI_MV), ADC_MV_TO_CODE(ADC_MON_LO_MV),
+                      ADC_EVT_TRIPHI | ADC_EVT_TRIPLO, ADC_EVT_TRIPHI | ADC_EVT_TRIPLO);
 
     // PWM
     SysCtl_disablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);
     PinMux_init();
     SYNC_init();
-    initEPWM(EPWM1_BASE);     // Initialize ePWM settings
-    EPWM_setClockPrescaler(EPWM1_BASE, EPWM_CLOCK_DIVIDER_4, EPWM_HSCLOCK_DIVIDER_1); // Explicitly set prescaler values
+    initEPWM(EPWM1_BASE);     // Initialize ePWM settings (precomputed constants only)
+#if PWM_GROUP
+    for (i = 0; i < PWM_GROUP_PHASES; i++)
+    {
+        GPIO_setPinConfig(pwmGroupPins[i]);
+        pwmGroupDuty[i] = PWM_DUTY_PERMILLE / 1000.0f;
+        pwmGroupPhase[i] = (float32_t)i / PWM_GROUP_PHASES;
+    }
+    pwm_group_init(&pwmGroup, EPWM1_BASE, pwmGroupBases, PWM_GROUP_PHASES,
+                   (EPWM_ClockDivider)PWM_CLKDIV_LOG2, PWM_DUTY_PERMILLE / 1000.0f);
+#endif
+#if PWM_TRIP
+    Interrupt_register(INT_EPWM1_TZ, &epwm1TzISR);
+    Interrupt_enable(INT_EPWM1_TZ);
+    pwm_trip_init(&pwmTrip, &pwmTripCfg, pwmTripBases, sizeof(pwmTripBases) / sizeof(pwmTripBases[0]),
+                  PWM_TRIP_MV);
+#endif
+#if ADC_TRIGGER_EPWM
+    // Sample clock on ePWM2: same TBCLK, SAMPLING_FREQ / PWM_FREQ samples per PWM cycle (up-down: 2 * TBPRD)
+    EPWM_setClockPrescaler(EPWM2_BASE, (EPWM_ClockDivider)PWM_CLKDIV_LOG2, EPWM_HSCLOCK_DIVIDER_1);
+    if (!sample_clock_init(&sampleClock, EPWM1_BASE, EPWM2_BASE, 2UL * PWM_TBPRD,
+                           (uint16_t)(SAMPLING_FREQ / PWM_FREQ), SAMPLE_POINT_TBCLK, TBCLK))
+    {
+        ESTOP0; // PWM cycle is not a whole number of sample slots
+    }
+#endif
+#if PWM_WAVE
+    // DMA channel 6 reloads CMPA once per PWM cycle, interrupts once per waveform period
+    DMA_initController();
+    DMA_setEmulationMode(DMA_EMULATION_FREE_RUN);
+    Interrupt_register(INT_DMA_CH6, &dmaCh6ISR);
+    Interrupt_enable(INT_DMA_CH6);
+    pwm_wave_init(&pwmWave, EPWM1_BASE, DMA_CH6_BASE, pwmWaveTables, PWM_WAVE_MAX_LEN,
+                  (float32_t)PWM_FREQ);
+    if (!pwm_wave_set(&pwmWave, NULL, 0, PWM_WAVE_AMPLITUDE, PWM_WAVE_FREQ))
+    {
+        ESTOP0; // PWM_FREQ / PWM_WAVE_FREQ outside 2..PWM_WAVE_MAX_LEN
+    }
+    pwm_wave_start(&pwmWave);
+#endif
     SysCtl_enablePeripheral(SYSCTL_PERIPH_CLK_TBCLKSYNC);     // Re-enable time-base clock sync to start all ePWM counters
     DEVICE_DELAY_US(100);  // Delay for 100 microseconds to settle the PLL
-
+#if PWM_HR
+    // Measure the MEP step (HRMSTEP), then move ePWM1A to high-resolution duty
+    pwm_hr_calibrate(&pwmHrCalCfg, &pwmHrCal);
+    pwm_hr_init(&pwm1, EPWM1_BASE, TBCLK, true);
+    pwm_hr_setDuty(&pwm1, PWM_DUTY_PERMILLE / 1000.0f);
+#endif
+
+#if !ADC_TRIGGER_EPWM
     // start the timer
     CPUTimer_startTimer(CPUTIMER0_BASE);
+#endif
 
-    // Initialize rawData and measuredVals arrays
-    for (i = 0; i < ADC_BUF_LEN; i++)
+    // Initialize rawData and measuredMv arrays
+    for (i = 0; i < ADC_BLOCKS * ADC_CHANNELS * ADC_BUF_LEN; i++)
     {
         rawData[i] = 0;
-        measuredVals[i]=0;
+    }
+    for (i = 0; i < ADC_CHANNELS * ADC_BUF_LEN; i++)
+    {
+        measuredMv[i] = 0;
+    }
+
+    // Digital to mV linear scale (VREFHI = 3V, SRC: LaunchPad XL datasheet); stored samples
+    // are sums of ADC_OSR codes, shifted right by adcAcq.sumShift in 16-bit mode
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        adc_cal_init(&adcCal[i], adcAcq.codeBits, ADC_CAL_SEGMENTS, ADC_DIFF16,
+                     ADC_MV_PER_CODE * (float32_t)(1U << adcAcq.sumShift) / ADC_OSR, 0.0f);
     }
 
+    // Polyphase FIR decimate by 5 on every channel
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        decim_init(&adcDecim[i], 0, 1, decimLowpass5, DECIM_LOWPASS5_TAPS, DECIM_RATIO, ADC_DIFF16);
+    }
+
+    // ADC_CHANNELS channels of ADC_BUF_LEN frames per block
+#if ADC_PLANAR
+    buf_pool_init(&adcPool, adcDesc, rawData, ADC_BLOCKS, ADC_CHANNELS, ADC_BUF_LEN,
+                  ADC_BUF_LEN, 1);
+#else
+    buf_pool_init(&adcPool, adcDesc, rawData, ADC_BLOCKS, ADC_CHANNELS, ADC_BUF_LEN,
+                  1, ADC_CHANNELS);
+#endif
+    adcBlock = buf_pool_startFill(&adcPool);
+
+#if CRC_MON
+    // After their initialisation: the first pass takes the current contents as golden
+    crc_mon_init(&crcMon, crcRegions, CRC_MON_REGIONS, CRC_MON_SLICE_WORDS);
+    crc_mon_add(&crcMon, decimLowpass5, sizeof(decimLowpass5), 0, false);
+    crc_mon_add(&crcMon, decimCic3Comp, sizeof(decimCic3Comp), 0, false);
+    crc_mon_add(&crcMon, adcInputs, sizeof(adcInputs), 0, false);
+    for (i = 0; i < ADC_CHANNELS; i++)
+    {
+        crcCalRegion[i] = crc_mon_add(&crcMon, &adcCal[i].table, sizeof(adcCal[i].table), 0, false);
+    }
+#endif
+
+    isrNest[NEST_ADC].intNumber = adcAcq.intNumber;
+    isr_nest_init(isrNest, sizeof(isrNest) / sizeof(isrNest[0]));
+
     EINT;  // Enable Global interrupt INTM
     ERTM;  // Enable Global realtime interrupt DBGM
 
     // main loop
     while (1)
     {
-        // Continuously check if buffer is filled for further processing
-        if (adcBufferIndex >= ADC_BUF_LEN)
+        // Continuously check if a block is filled for further processing.
+        // The block is owned here until released: the ISR keeps filling the
+        // other blocks and never touches this one.
+        BufDesc *block = buf_pool_acquire(&adcPool);
+
+        if (block != NULL)
         {
-            asm(" NOP"); // debugging breakpoint
-            adcBufferIndex = 0;  // Reset buffer index after filling
+            // Scale the whole block at once, outside the ISR (layout is kept)
+            REGION_PROF_BEGIN(REGION_SCALE);
+            for (i = 0; i < block->channels; i++)
+            {
+                uint16_t *src = bufdesc_channel(block, i);
+
+                adc_cal_apply(&adcCal[i].table, src, block->frStride,
+                              &measuredMv[src - block->data], block->frames);
+            }
+            REGION_PROF_END(REGION_SCALE);
+            REGION_PROF_BEGIN(REGION_REPORT);
+            adc_acq_report(&adcAcq, block, ADC_REPORT_CHANNEL, &adcReport);
+            REGION_PROF_END(REGION_REPORT);
+
+            // Decimate every channel in place from the block (planar or interleaved)
+            REGION_PROF_BEGIN(REGION_DECIM);
+            for (i = 0; i < block->channels; i++)
+            {
+                decim_process(&adcDecim[i], bufdesc_channel(block, i), block->frStride,
+                              block->frames, decimated[i]);
+            }
+            REGION_PROF_END(REGION_DECIM);
+            if ((calCommand != 0U) && (calChannel < block->channels))
+            {
+                if (calCommand == CAL_ADD_POINT)
+                {
+                    adc_cal_addPoint(&adcCal[calChannel], block, calChannel, calPointMv);
+                }
+                else if (calCommand == CAL_BUILD)
+                {
+                    adc_cal_build(&adcCal[calChannel]);
+                }
+                else if (calCommand == CAL_CLEAR)
+                {
+                    adc_cal_clear(&adcCal[calChannel]);
+                }
+#if CRC_MON
+                if ((calCommand == CAL_BUILD) || (calCommand == CAL_CLEAR))
+                {
+                    crc_mon_relearn(&crcMon, crcCalRegion[calChannel]);  // Table legitimately rewritten
+                }
+#endif
+                calCommand = 0;
+            }
+#if PWM_HR
+            // SFO-style background recalibration
+            if (++pwmHrBlocks >= PWM_HR_RECAL_BLOCKS)
+            {
+                pwm_hr_calibrate(&pwmHrCalCfg, &pwmHrCal);
+                pwmHrBlocks = 0;
+            }
+#endif
+#if PWM_GROUP
+            if (pwmGroupCommit != 0U)
+            {
+                for (i = 0; i < PWM_GROUP_PHASES; i++)
+                {
+                    pwm_group_setDuty(&pwmGroup, i, pwmGroupDuty[i]);
+                    pwm_group_setPhase(&pwmGroup, i, pwmGroupPhase[i]);
+                }
+                pwm_group_commit(&pwmGroup);
+                pwmGroupCommit = 0;
+            }
+#endif
+#if PWM_TRIP
+            if ((pwmTripRearm != 0U) && pwm_trip_rearm(&pwmTrip))
+            {
+                pwmTripRearm = 0;
+            }
+#endif
+#if CLK_MON
+            if (clk_mon_poll(&clkMon) && clkMon.ok)
+            {
+                sysClockFreq = clkMon.measuredHz;
+#if !ADC_TRIGGER_EPWM
+                // Retune once the timer clock drifts from the one sampleRate assumes (with the
+                // ePWM trigger the sample clock is locked to the PWM: only reported)
+                float32_t drift = ((float32_t)clkMon.measuredHz - (float32_t)sampleRate.clkHz) *
+                                  1.0e6f / (float32_t)sampleRate.clkHz;
+                if ((drift > CLK_MON_CORRECT_PPM) || (drift < -CLK_MON_CORRECT_PPM))
+                {
+                    rate_gen_setClock(&sampleRate, clkMon.measuredHz);
+                }
+#endif
+            }
+#endif
+            asm(" NOP"); // debugging breakpoint: block->data, measuredMv (channel c: bufdesc_channel(block, c) when planar)
+            buf_pool_release(&adcPool, block);
         }
+#if CRC_MON
+        else
+        {
+            // Idle: next slice of the integrity check
+            crc_mon_step(&crcMon);
+        }
+#endif
     }
 }
 
@@ -118,81 +620,54 @@ void initCPUTimers(void)
     CPUTimer_reloadTimerCounter(CPUTIMER0_BASE);
 }
 
-// Configure CPU Timer
-void configCPUTimer(uint32_t cpuTimer, float freq, float fs)
-{
-    uint32_t temp = (uint32_t)(freq / fs);
-
-    // Initialize timer period
-    CPUTimer_setPeriod(cpuTimer, temp);
-
-    // Set pre-scale counter to divide by 1 (SYSCLKOUT)
-    CPUTimer_setPreScaler(cpuTimer, 0);
-
-    // Initializes timer control register. The timer is stopped, reloaded,
-    // free run disabled, and interrupt enabled.
-    CPUTimer_stopTimer(cpuTimer);
-    CPUTimer_reloadTimerCounter(cpuTimer);
-    CPUTimer_setEmulationMode(cpuTimer, CPUTIMER_EMULATIONMODE_STOPAFTERNEXTDECREMENT);
-    CPUTimer_enableInterrupt(cpuTimer);
-}
-
-
-// Configure ADC (Only ADCA is used here)
+// Configure ADCA..ADCD from the adcInputs[] table
 void configureADC(void)
 {
-    // Set the prescaler to divide the ADC clock by 4
-    ADC_setPrescaler(ADCA_BASE, ADC_CLK_DIV_4_0);
-
-    ADC_setMode(ADCA_BASE, ADC_RESOLUTION_12BIT, ADC_MODE_SINGLE_ENDED);
-
-    // Set pulse positions to late
-    ADC_setInterruptPulseMode(ADCA_BASE, ADC_PULSE_END_OF_CONV);
-
-    // Power up the ADC module
-    ADC_enableConverter(ADCA_BASE);
-
-    // Delay for 1 ms to allow the ADC to power up
-    DEVICE_DELAY_US(1000);
-}
-
-// Configure SOC for ADCA conversion
-void configureADCSOC(void)
-{
-    // Configure SOC0 of ADCA to sample on ADC channel A0 (ADCINA0)
-    ADC_setupSOC(ADCA_BASE, ADC_SOC_NUMBER0, ADC_TRIGGER_CPU1_TINT0, ADC_CH_ADCIN0, ADC_ACQPS_TICKS);
-
-    // Set interrupt source to end of SOC0
-    ADC_setInterruptSource(ADCA_BASE, ADC_INT_NUMBER1, ADC_SOC_NUMBER0);
-
-    // Enable interrupt for SOC0
-    ADC_enableInterrupt(ADCA_BASE, ADC_INT_NUMBER1);
-
-    // Clear the interrupt flag
-    ADC_clearInterruptStatus(ADCA_BASE, ADC_INT_NUMBER1);
+#if ADC_TRIGGER_EPWM
+    ADC_Trigger trigger = ADC_TRIGGER_EPWM2_SOCA;
+#else
+    ADC_Trigger trigger = ADC_TRIGGER_CPU1_TINT0;
+#endif
+
+    // ADC_CFG_PRESCALE clock, ADC_DIFF16 mode, ADC_OSR round-robin SOCs per input on the shared trigger
+    if (!adc_acq_init(&adcAcq, adcInputs, ADC_CHANNELS, trigger, ADC_ACQPS_TICKS,
+                      ADC_CFG_PRESCALE, ADC_CFG_RESOLUTION, ADC_CFG_SIGNAL_MODE,
+                      ADC_OSR, DEVICE_SYSCLK_FREQ))
+    {
+        ESTOP0; // adcInputs[] does not fit the SOCs
+    }
 }
 
 
 // Interrupt Service Routine for ADC
 __interrupt void adcA1ISR(void)
 {
-
-    // Store ADC result in buffer
-    if (adcBufferIndex < ADC_BUF_LEN)
+#if ADC_TRIGGER_EPWM
+    ISR_PROF_ENTER(ISR_ID_ADC, isr_prof_epwmAge(EPWM2_BASE, sampleClock.pointTbclk,
+                                                (uint16_t)(DEVICE_SYSCLK_FREQ / TBCLK)));
+#else
+    ISR_PROF_ENTER(ISR_ID_ADC, ISR_PROF_TIMER_AGE(CPUTIMER0_BASE));
+#endif
+
+    REGION_PROF_BEGIN(REGION_ADC_ISR);
+    // Store the raw channel vector in the current block (scaled later by the consumer)
+    adc_acq_readFrame(&adcAcq, adcBlock, adcBufferIndex);
+
+    // Block full: hand it over and continue in a free one
+    adcBufferIndex++;
+    if (adcBufferIndex >= ADC_BUF_LEN)
     {
-        static float32_t conversionFactor = 3.0 / (4096 - 1); // 12 bits digital to 3->0 linear scale (VREFHI = 3V, SRC: LaunchPad XL datasheet)
-        
-        rawData[adcBufferIndex] = ADC_readResult(ADCARESULT_BASE, ADC_SOC_NUMBER0);
-        measuredVals[adcBufferIndex] =(rawData[adcBufferIndex] * conversionFactor);
-
-        adcBufferIndex++;
+        adcBlock = buf_pool_rotate(&adcPool, adcBlock);
+        adcBufferIndex = 0;
     }
 
     // Clear ADC interrupt flag
-    ADC_clearInterruptStatus(ADCA_BASE, ADC_INT_NUMBER1);
+    adc_acq_clearInterrupt(&adcAcq);
 
     // Acknowledge interrupt in PIE
     Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP1);
+    REGION_PROF_END(REGION_ADC_ISR);
+    ISR_PROF_EXIT(ISR_ID_ADC);
 }
 
 
@@ -200,18 +675,14 @@ __interrupt void adcA1ISR(void)
 // Configure ePWM module
 void initEPWM(uint32_t base)
 {
-    uint32_t tbclk = TBCLK / TBCLK_DIVIDER;      // e.g. 100 MHz / 4 = 25 MHz
-    uint16_t tbprd = (tbclk / (2 * PWM_FREQ)) - 1;
-
-    EPWM_setTimeBasePeriod(base, tbprd);
+    // up-down: one cycle is 2 * PWM_TBPRD TBCLK
+    EPWM_setClockPrescaler(base, (EPWM_ClockDivider)PWM_CLKDIV_LOG2, EPWM_HSCLOCK_DIVIDER_1);
+    EPWM_setTimeBasePeriod(base, PWM_TBPRD);
     EPWM_setPhaseShift(base, 0);
     EPWM_disablePhaseShiftLoad(base);
     EPWM_setTimeBaseCounter(base, 0);
 
-    float duty = 0.25f;               // 25%
-    uint16_t cmpa = (uint16_t)((1.0f - duty) * (tbprd + 1.0f) + 0.5f);
-
-    EPWM_setCounterCompareValue(base, EPWM_COUNTER_COMPARE_A, cmpa);
+    EPWM_setCounterCompareValue(base, EPWM_COUNTER_COMPARE_A, PWM_CMPA);
 
     // Setting up-dowm mode
     EPWM_setTimeBaseCounterMode(base, EPWM_COUNTER_MODE_UP_DOWN);
@@ -234,5 +705,47 @@ void initEPWM(uint32_t base)
                                   EPWM_AQ_OUTPUT_A,
                                   EPWM_AQ_OUTPUT_LOW,
                                   EPWM_AQ_OUTPUT_ON_TIMEBASE_DOWN_CMPA);
+#if PWM_DEADBAND_NS > 0
+    // ePWM1B: inverted ePWM1A, both edges delayed by PWM_DEADBAND_NS (active high complementary)
+    EPWM_setRisingEdgeDeadBandDelayInput(base, EPWM_DB_INPUT_EPWMA);
+    EPWM_setFallingEdgeDeadBandDelayInput(base, EPWM_DB_INPUT_EPWMA);
+    EPWM_setDeadBandDelayPolarity(base, EPWM_DB_RED, EPWM_DB_POLARITY_ACTIVE_HIGH);
+    EPWM_setDeadBandDelayPolarity(base, EPWM_DB_FED, EPWM_DB_POLARITY_ACTIVE_LOW);
+    EPWM_setDeadBandDelayMode(base, EPWM_DB_RED, true);
+    EPWM_setDeadBandDelayMode(base, EPWM_DB_FED, true);
+    EPWM_setRisingEdgeDelayCount(base, PWM_DB_COUNTS);
+    EPWM_setFallingEdgeDelayCount(base, PWM_DB_COUNTS);
+#endif
 }
 
+
+#if PWM_WAVE
+// DMA channel 6: end of one waveform period, switches to a new table if pwm_wave_set() built one
+__interrupt void dmaCh6ISR(void)
+{
+    ISR_PROF_ENTER(ISR_ID_PWM_WAVE, ISR_PROF_NO_AGE);
+    ISR_NEST_ENTER(&isrNest[NEST_PWM_WAVE]);  // Acknowledges group 7, lets adcA1ISR in
+    pwm_wave_onTransferEnd(&pwmWave);
+    ISR_NEST_EXIT();
+
+    // Acknowledge interrupt in PIE
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP7);
+    ISR_PROF_EXIT(ISR_ID_PWM_WAVE);
+}
+#endif
+
+
+#if PWM_TRIP
+// ePWM1 one-shot trip: outputs are already low, only record what happened
+__interrupt void epwm1TzISR(void)
+{
+    ISR_PROF_ENTER(ISR_ID_PWM_TRIP, ISR_PROF_NO_AGE);
+    ISR_NEST_ENTER(&isrNest[NEST_PWM_TRIP]);
+    pwm_trip_onTrip(&pwmTrip);
+    ISR_NEST_EXIT();
+
+    // Acknowledge interrupt in PIE
+    Interrupt_clearACKGroup(INTERRUPT_ACK_GROUP2);
+    ISR_PROF_EXIT(ISR_ID_PWM_TRIP);
+}
+#endif
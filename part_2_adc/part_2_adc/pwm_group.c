@@ -0,0 +1,174 @@
+//#############################################################################
+// File: pwm_group.c
+// Chapter: PWM
+// Code description: globally loaded multi-phase ePWM group. See pwm_group.h.
+//#############################################################################
+
+#include "pwm_group.h"
+
+//---------------------------------------------------------------------------
+// Helpers
+//---------------------------------------------------------------------------
+// ePWM modules are 0x100 apart
+static inline EPWM_CurrentLink linkOf(uint32_t base)
+{
+    return (EPWM_CurrentLink)((base - EPWM1_BASE) >> 8);
+}
+
+static uint16_t dutyToCmp(uint16_t tbprd, float32_t duty)
+{
+    float32_t cmp;
+
+    if (duty < 0.0f)
+    {
+        duty = 0.0f;
+    }
+    else if (duty > 1.0f)
+    {
+        duty = 1.0f;
+    }
+    // duty = (TBPRD - CMPA) / TBPRD
+    cmp = (float32_t)tbprd * (1.0f - duty) + 0.5f;
+    return (uint16_t)cmp;
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+bool pwm_group_init(PwmGroup *g, uint32_t refBase, const uint32_t *bases,
+                    uint16_t count, EPWM_ClockDivider clkdiv, float32_t duty)
+{
+    uint16_t i;
+
+    if ((count == 0U) || (count > PWM_GROUP_MAX))
+    {
+        return false;
+    }
+
+    g->refBase = refBase;
+    g->count   = count;
+    g->tbprd   = EPWM_getTimeBasePeriod(refBase);
+    g->commits = 0;
+
+    EPWM_setSyncOutPulseMode(refBase, EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO);
+
+    for (i = 0; i < count; i++)
+    {
+        uint32_t base = bases[i];
+
+        g->base[i] = base;
+        EPWM_setClockPrescaler(base, clkdiv, EPWM_HSCLOCK_DIVIDER_1);
+        EPWM_setTimeBasePeriod(base, g->tbprd);
+        EPWM_setTimeBaseCounterMode(base, EPWM_COUNTER_MODE_UP_DOWN);
+        EPWM_setTimeBaseCounter(base, 0);
+        EPWM_enablePhaseShiftLoad(base);
+        EPWM_setSyncOutPulseMode(base, EPWM_SYNC_OUT_PULSE_DISABLED);
+
+        // Initial duty straight into the active register, then shadowed
+        EPWM_disableCounterCompareShadowLoadMode(base, EPWM_COUNTER_COMPARE_A);
+        EPWM_setCounterCompareValue(base, EPWM_COUNTER_COMPARE_A,
+                                    dutyToCmp(g->tbprd, duty));
+        EPWM_setCounterCompareShadowLoadMode(base, EPWM_COUNTER_COMPARE_A,
+                                             EPWM_COMP_LOAD_ON_CNTR_ZERO);
+
+        EPWM_setActionQualifierAction(base, EPWM_AQ_OUTPUT_A,
+                                      EPWM_AQ_OUTPUT_HIGH,
+                                      EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
+        EPWM_setActionQualifierAction(base, EPWM_AQ_OUTPUT_A,
+                                      EPWM_AQ_OUTPUT_LOW,
+                                      EPWM_AQ_OUTPUT_ON_TIMEBASE_DOWN_CMPA);
+
+        // CMPA shadow -> active only on a zero after a one-shot latch
+        EPWM_enableGlobalLoadRegisters(base, EPWM_GL_REGISTER_CMPA_CMPAHR);
+        EPWM_setGlobalLoadTrigger(base, EPWM_GL_LOAD_PULSE_CNTR_ZERO);
+        EPWM_setGlobalLoadEventPrescale(base, 1);
+        EPWM_enableGlobalLoadOneShotMode(base);
+        EPWM_enableGlobalLoad(base);
+        if (i > 0U)
+        {
+            // Writes to the master's GLDCTL2 (one-shot latch) reach this one
+            EPWM_setupEPWMLinks(base, linkOf(bases[0]), EPWM_LINK_GLDCTL2);
+        }
+
+        pwm_group_setPhase(g, i, (float32_t)i / (float32_t)count);
+        EPWM_setPhaseShift(base, g->tbphs[i]);
+        EPWM_setCountModeAfterSync(base, g->countUp[i] ?
+                                   EPWM_COUNT_MODE_UP_AFTER_SYNC :
+                                   EPWM_COUNT_MODE_DOWN_AFTER_SYNC);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Staging
+//---------------------------------------------------------------------------
+void pwm_group_setDuty(PwmGroup *g, uint16_t i, float32_t duty)
+{
+    // Shadow only while global load is in one-shot mode
+    EPWM_setCounterCompareValue(g->base[i], EPWM_COUNTER_COMPARE_A,
+                                dutyToCmp(g->tbprd, duty));
+}
+
+// A member lagging by p is, on the reference's zero, 2 * TBPRD * (1 - p)
+// into its own cycle, plus the sync delay when TBPHS is loaded. Up-down:
+// the first TBPRD of the cycle counts up from 0, the rest down from TBPRD.
+void pwm_group_setPhase(PwmGroup *g, uint16_t i, float32_t phase)
+{
+    uint32_t cycle = 2UL * g->tbprd;
+    uint32_t lag;
+    uint32_t t;
+
+    phase -= (float32_t)(int32_t)phase;
+    if (phase < 0.0f)
+    {
+        phase += 1.0f;
+    }
+    lag = (uint32_t)(phase * (float32_t)cycle + 0.5f) % cycle;
+    t = (cycle - lag + PWM_GROUP_SYNC_DELAY) % cycle;
+
+    g->phase[i] = phase;
+    if (t < g->tbprd)
+    {
+        g->tbphs[i]   = (uint16_t)t;
+        g->countUp[i] = true;
+    }
+    else
+    {
+        g->tbphs[i]   = (uint16_t)(cycle - t);
+        g->countUp[i] = false;
+    }
+}
+
+//---------------------------------------------------------------------------
+// Commit
+//---------------------------------------------------------------------------
+void pwm_group_commit(PwmGroup *g)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+    uint16_t i;
+
+    // Keep the phase writes clear of the reference's sync pulse, so that
+    // all members switch on the same one
+    while ((EPWM_getTimeBaseCounterDirection(g->refBase) ==
+            EPWM_TIME_BASE_STATUS_COUNT_DOWN) &&
+           (EPWM_getTimeBaseCounterValue(g->refBase) <= PWM_GROUP_COMMIT_GUARD))
+    {
+    }
+
+    for (i = 0; i < g->count; i++)
+    {
+        EPWM_setPhaseShift(g->base[i], g->tbphs[i]);
+        EPWM_setCountModeAfterSync(g->base[i], g->countUp[i] ?
+                                   EPWM_COUNT_MODE_UP_AFTER_SYNC :
+                                   EPWM_COUNT_MODE_DOWN_AFTER_SYNC);
+    }
+
+    // Linked: arms the one-shot load on every member
+    EPWM_setGlobalLoadOneShotLatch(g->base[0]);
+    g->commits++;
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
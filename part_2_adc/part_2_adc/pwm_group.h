@@ -0,0 +1,88 @@
+//#############################################################################
+// File: pwm_group.h
+// Chapter: PWM
+// Code description: multi-phase group of up-down ePWMs that follow a
+// reference PWM (same TBPRD and TBCLK), each shifted by its own phase. New
+// duty and phase sets are staged and then committed together, with no ISR:
+//  - duty: CMPA is written to the shadow only. Global load is enabled on
+//    every member in one-shot mode, and the members' GLDCTL2 registers are
+//    linked to the first member's, so a single one-shot latch write arms
+//    all of them. Each member then loads its CMPA at its own counter = zero,
+//    all within the next PWM cycle, and none loads on later zeros until
+//    the next commit. A half-written set is never seen by the hardware.
+//  - phase: TBPHS has no shadow. It is loaded on every sync pulse from the
+//    reference (counter = zero), so the commit writes all members' TBPHS and
+//    count directions while the reference is away from its zero, and they
+//    take effect on the same sync.
+//
+// Phase p (0..1 of a cycle) is a lag behind the reference: member zero
+// p * 2 * TBPRD TBCLK after the reference zero. The members' sync inputs
+// must be driven by the reference's sync out (SYNC_init(): ePWM1 -> ePWM4,
+// 7, 10); pwm_group_init() sets the reference's sync out at counter = zero.
+//#############################################################################
+
+#ifndef PWM_GROUP_H
+#define PWM_GROUP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define PWM_GROUP_MAX           4U      // Members
+#define PWM_GROUP_SYNC_DELAY    2U      // TBCLK from the reference's zero to
+                                        // the phase load (sample_clock.h)
+#define PWM_GROUP_COMMIT_GUARD  128U    // TBCLK before the reference's zero
+                                        // in which phases are not written
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t  refBase;              // Sync source, not a member
+    uint16_t  count;
+    uint32_t  base[PWM_GROUP_MAX];  // base[0] is the global load master
+    uint16_t  tbprd;                // Shared with the reference
+
+    // Staged by pwm_group_setPhase(), written by pwm_group_commit()
+    float32_t phase[PWM_GROUP_MAX]; // Lag, fraction of a cycle
+    uint16_t  tbphs[PWM_GROUP_MAX];
+    bool      countUp[PWM_GROUP_MAX];
+
+    uint32_t  commits;
+} PwmGroup;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Set up count ePWMs (bases) like the reference, which must already have
+// its TBPRD: up-down, same clock divider, high on up-count CMPA and low on
+// down-count CMPA, channel A only. Phases start interleaved (i / count) at
+// duty. Call with TBCLKSYNC disabled. Returns false for 0 or more than
+// PWM_GROUP_MAX members.
+bool pwm_group_init(PwmGroup *g, uint32_t refBase, const uint32_t *bases,
+                    uint16_t count, EPWM_ClockDivider clkdiv, float32_t duty);
+
+// Stage a duty 0..1 (high time / cycle) for member i
+void pwm_group_setDuty(PwmGroup *g, uint16_t i, float32_t duty);
+
+// Stage a phase lag 0..1 (of a cycle) for member i
+void pwm_group_setPhase(PwmGroup *g, uint16_t i, float32_t phase);
+
+// Apply all staged duties and phases. May wait up to
+// PWM_GROUP_COMMIT_GUARD TBCLK for the reference to pass its zero.
+void pwm_group_commit(PwmGroup *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_GROUP_H
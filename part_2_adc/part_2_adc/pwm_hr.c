@@ -0,0 +1,270 @@
+//#############################################################################
+// File: pwm_hr.c
+// Chapter: PWM
+// Code description: HRPWM duty/period and MEP step calibration. See pwm_hr.h.
+//#############################################################################
+
+#include <math.h>
+#include "device.h"
+#include "pwm_hr.h"
+
+#define PWM_HR_CAL_FLAGS    (ECAP_ISR_SOURCE_CAPTURE_EVENT_1 |  \
+                             ECAP_ISR_SOURCE_CAPTURE_EVENT_2 |  \
+                             ECAP_ISR_SOURCE_CAPTURE_EVENT_3 |  \
+                             ECAP_ISR_SOURCE_CAPTURE_EVENT_4)
+#define PWM_HR_CAL_TIMEOUT  0xFFFFUL    // Polls before giving up on the eCAP
+#define PWM_HR_MAX_STEPS    255U        // Raw MEP steps in CMPAHR[15:8]
+
+//---------------------------------------------------------------------------
+// Register writes (integer part always, fraction with HR on)
+//---------------------------------------------------------------------------
+static void writeCompare(const PwmHr *p)
+{
+    if (p->hr)
+    {
+        HRPWM_setCounterCompareValue(p->base, HRPWM_COUNTER_COMPARE_A,
+                                     p->cmpQ8);
+    }
+    else
+    {
+        EPWM_setCounterCompareValue(p->base, EPWM_COUNTER_COMPARE_A,
+                                    pwm_hr_whole(p->cmpQ8));
+    }
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+bool pwm_hr_init(PwmHr *p, uint32_t base, uint32_t tbclkHz, bool hr)
+{
+    uint16_t tbprd = EPWM_getTimeBasePeriod(base);
+
+    if (hr && ((HWREGH(base + EPWM_O_TBCTL) &
+                (EPWM_TBCTL_CLKDIV_M | EPWM_TBCTL_HSPCLKDIV_M)) != 0U))
+    {
+        return false;
+    }
+
+    p->base     = base;
+    p->hr       = hr;
+    p->tbclkHz  = tbclkHz;
+    p->periodQ8 = (uint32_t)tbprd << 8;
+    p->cmpQ8    = (uint32_t)EPWM_getCounterCompareValue(base,
+                                  EPWM_COUNTER_COMPARE_A) << 8;
+    p->duty     = (tbprd != 0U) ?
+                  1.0f - (float32_t)p->cmpQ8 / (float32_t)p->periodQ8 : 0.0f;
+    p->freqHz   = (tbprd != 0U) ?
+                  (float32_t)tbclkHz / (2.0f * (float32_t)tbprd) : 0.0f;
+
+    if (hr)
+    {
+        // Up-down: both edges move, period fraction through TBPRDHR
+        HRPWM_setMEPEdgeSelect(base, HRPWM_CHANNEL_A,
+                               HRPWM_MEP_CTRL_RISING_AND_FALLING_EDGE);
+        HRPWM_setMEPControlMode(base, HRPWM_CHANNEL_A,
+                                HRPWM_MEP_DUTY_PERIOD_CTRL);
+        HRPWM_setCounterCompareShadowLoadEvent(base, HRPWM_CHANNEL_A,
+                                               HRPWM_LOAD_ON_CNTR_ZERO);
+        HRPWM_enableAutoConversion(base);
+        HRPWM_enablePeriodControl(base);
+
+        // Until the first calibration
+        if ((HWREGH(EPWM1_BASE + HRPWM_O_HRMSTEP) &
+             HRPWM_HRMSTEP_HRMSTEP_M) == 0U)
+        {
+            HRPWM_setMEPStep(EPWM1_BASE, PWM_HR_MEP_NOMINAL);
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Period and duty
+//---------------------------------------------------------------------------
+bool pwm_hr_setFrequency(PwmHr *p, float32_t hz)
+{
+    uint32_t period;
+
+    if (!pwm_hr_calcPeriod(p->tbclkHz, hz, p->hr, &period))
+    {
+        return false;
+    }
+
+    p->periodQ8 = period;
+    p->freqHz   = 256.0f * (float32_t)p->tbclkHz / (2.0f * (float32_t)period);
+    if (p->hr)
+    {
+        HRPWM_setTimeBasePeriod(p->base, period);
+    }
+    else
+    {
+        EPWM_setTimeBasePeriod(p->base, pwm_hr_whole(period));
+    }
+    pwm_hr_setDuty(p, p->duty);
+    return true;
+}
+
+void pwm_hr_setDuty(PwmHr *p, float32_t duty)
+{
+    if (duty < 0.0f)
+    {
+        duty = 0.0f;
+    }
+    else if (duty > 1.0f)
+    {
+        duty = 1.0f;
+    }
+    p->duty  = duty;
+    p->cmpQ8 = pwm_hr_calcCompare(p->periodQ8, duty, p->hr);
+    writeCompare(p);
+}
+
+//---------------------------------------------------------------------------
+// Calibration: average high time of the spare PWM, in SYSCLK
+//---------------------------------------------------------------------------
+static float32_t highTime(uint32_t ecap)
+{
+    uint32_t sum = 0;
+    uint16_t k;
+
+    for (k = 0; k < PWM_HR_CAL_AVERAGE; k++)
+    {
+        uint32_t polls = 0;
+
+        ECAP_clearInterrupt(ecap, PWM_HR_CAL_FLAGS);
+        ECAP_reArm(ecap);
+        while ((ECAP_getInterruptSource(ecap) &
+                ECAP_ISR_SOURCE_CAPTURE_EVENT_4) == 0U)
+        {
+            if (++polls > PWM_HR_CAL_TIMEOUT)
+            {
+                return -1.0f;
+            }
+        }
+        // Rising (1, 3) and falling (2, 4) edges of two pulses
+        sum += ECAP_getEventTimeStamp(ecap, ECAP_EVENT_2) -
+               ECAP_getEventTimeStamp(ecap, ECAP_EVENT_1);
+        sum += ECAP_getEventTimeStamp(ecap, ECAP_EVENT_4) -
+               ECAP_getEventTimeStamp(ecap, ECAP_EVENT_3);
+    }
+    return (float32_t)sum / (float32_t)(2U * PWM_HR_CAL_AVERAGE);
+}
+
+static void setSteps(uint32_t pwm, uint16_t steps)
+{
+    HRPWM_setHiResCounterCompareValueOnly(pwm, HRPWM_COUNTER_COMPARE_A, steps);
+    DEVICE_DELAY_US(2);     // Loaded at the next zero (period 640 ns)
+}
+
+bool pwm_hr_calibrate(const PwmHr_CalConfig *cfg, PwmHr_Cal *cal)
+{
+    uint32_t pwm = cfg->pwmBase;
+    uint32_t ecap = cfg->ecapBase;
+    uint16_t m;
+    uint16_t mFirst = 0;
+    uint16_t mLast = 0;
+    float32_t h;
+    float32_t level;
+    float32_t stepsPerSysclk;
+    float32_t scale;
+    bool ok = false;
+
+    cal->runs++;
+    cal->crossings = 0;
+
+    // Spare PWM, up count: high from zero to CMPA, falling edge MEP-delayed
+    // by raw steps (no auto-conversion)
+    EPWM_setTimeBaseCounterMode(pwm, EPWM_COUNTER_MODE_STOP_FREEZE);
+    EPWM_setClockPrescaler(pwm, EPWM_CLOCK_DIVIDER_1, EPWM_HSCLOCK_DIVIDER_1);
+    EPWM_setTimeBasePeriod(pwm, PWM_HR_CAL_PERIOD - 1U);
+    EPWM_setTimeBaseCounter(pwm, 0);
+    EPWM_setCounterCompareShadowLoadMode(pwm, EPWM_COUNTER_COMPARE_A,
+                                         EPWM_COMP_LOAD_ON_CNTR_ZERO);
+    EPWM_setCounterCompareValue(pwm, EPWM_COUNTER_COMPARE_A,
+                                PWM_HR_CAL_PERIOD / 2U);
+    EPWM_setActionQualifierAction(pwm, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_HIGH,
+                                  EPWM_AQ_OUTPUT_ON_TIMEBASE_ZERO);
+    EPWM_setActionQualifierAction(pwm, EPWM_AQ_OUTPUT_A, EPWM_AQ_OUTPUT_LOW,
+                                  EPWM_AQ_OUTPUT_ON_TIMEBASE_UP_CMPA);
+    HRPWM_setMEPEdgeSelect(pwm, HRPWM_CHANNEL_A, HRPWM_MEP_CTRL_FALLING_EDGE);
+    HRPWM_setMEPControlMode(pwm, HRPWM_CHANNEL_A, HRPWM_MEP_DUTY_PERIOD_CTRL);
+    HRPWM_setCounterCompareShadowLoadEvent(pwm, HRPWM_CHANNEL_A,
+                                           HRPWM_LOAD_ON_CNTR_ZERO);
+    HRPWM_disableAutoConversion(pwm);
+    HRPWM_setHiResCounterCompareValueOnly(pwm, HRPWM_COUNTER_COMPARE_A, 0);
+    EPWM_setTimeBaseCounterMode(pwm, EPWM_COUNTER_MODE_UP);
+
+    // Pin -> input X-BAR -> eCAP
+    GPIO_setPinConfig(cfg->pinConfig);
+    GPIO_setQualificationMode(cfg->gpio, GPIO_QUAL_ASYNC);
+    XBAR_setInputPin(cfg->xbarInput, cfg->gpio);
+
+    // eCAP: absolute timestamps of rise, fall, rise, fall, then stop
+    ECAP_stopCounter(ecap);
+    ECAP_disableInterrupt(ecap, PWM_HR_CAL_FLAGS);
+    ECAP_enableCaptureMode(ecap);
+    ECAP_setCaptureMode(ecap, ECAP_ONE_SHOT_CAPTURE_MODE, ECAP_EVENT_4);
+    ECAP_setEventPrescaler(ecap, 0);
+    ECAP_setEventPolarity(ecap, ECAP_EVENT_1, ECAP_EVNT_RISING_EDGE);
+    ECAP_setEventPolarity(ecap, ECAP_EVENT_2, ECAP_EVNT_FALLING_EDGE);
+    ECAP_setEventPolarity(ecap, ECAP_EVENT_3, ECAP_EVNT_RISING_EDGE);
+    ECAP_setEventPolarity(ecap, ECAP_EVENT_4, ECAP_EVNT_FALLING_EDGE);
+    ECAP_disableCounterResetOnEvent(ecap, ECAP_EVENT_1);
+    ECAP_disableCounterResetOnEvent(ecap, ECAP_EVENT_2);
+    ECAP_disableCounterResetOnEvent(ecap, ECAP_EVENT_3);
+    ECAP_disableCounterResetOnEvent(ecap, ECAP_EVENT_4);
+    ECAP_enableTimeStampCapture(ecap);
+    ECAP_startCounter(ecap);
+
+    // Sweep the delay; record where the pulse passes each next half SYSCLK
+    DEVICE_DELAY_US(2);
+    h = highTime(ecap);
+    if (h >= 0.0f)
+    {
+        level = floorf(h + 0.5f) + 0.5f;
+        for (m = 1; m <= PWM_HR_MAX_STEPS; m++)
+        {
+            setSteps(pwm, m);
+            h = highTime(ecap);
+            if (h < 0.0f)
+            {
+                cal->crossings = 0;
+                break;
+            }
+            while (h >= level)
+            {
+                if (cal->crossings == 0U)
+                {
+                    mFirst = m;
+                }
+                mLast = m;
+                cal->crossings++;
+                level += 1.0f;
+            }
+        }
+    }
+
+    // Spare PWM and eCAP back to idle
+    EPWM_setTimeBaseCounterMode(pwm, EPWM_COUNTER_MODE_STOP_FREEZE);
+    ECAP_stopCounter(ecap);
+
+    if (cal->crossings >= 2U)
+    {
+        stepsPerSysclk = (float32_t)(mLast - mFirst) /
+                         (float32_t)(cal->crossings - 1U);
+        scale = stepsPerSysclk * (float32_t)cfg->sysclkHz /
+                (float32_t)cfg->tbclkHz + 0.5f;
+        if ((scale >= 1.0f) && (scale < 256.0f))
+        {
+            cal->mepScale = (uint16_t)scale;
+            cal->stepPs   = 1.0e12f / ((float32_t)cfg->sysclkHz * stepsPerSysclk);
+            HRPWM_setMEPStep(EPWM1_BASE, cal->mepScale);
+            ok = true;
+        }
+    }
+    if (!ok)
+    {
+        cal->failures++;
+    }
+    return ok;
+}
@@ -0,0 +1,107 @@
+//#############################################################################
+// File: pwm_hr.h
+// Chapter: PWM
+// Code description: high-resolution duty and period for an up-down ePWM,
+// through the HRPWM micro edge positioner (MEP). Duty and frequency are set
+// with the same calls whether HR is on or off: values are kept in 1/256
+// TBCLK, the integer part goes to CMPA/TBPRD and, with HR on, the fraction
+// to CMPAHR/TBPRDHR, which the auto-conversion logic scales by the MEP
+// steps per TBCLK held in HRMSTEP (shared by all modules, ePWM1 register).
+//
+// The MEP step (~150 ps) drifts with voltage and temperature, so HRMSTEP has
+// to be measured, as TI's SFO library does. pwm_hr_calibrate() does this
+// with a spare ePWM and an eCAP: the spare ePWM's falling edge is delayed
+// by 0..255 raw MEP steps while the eCAP times the high pulse in SYSCLK.
+// The pulse grows by one SYSCLK every time the delay crosses a SYSCLK edge,
+// so the step counts between those crossings give the steps per SYSCLK,
+// and from that the steps per TBCLK. Call it at startup and again from the
+// background loop from time to time.
+//
+// HRPWM needs TBCLK = EPWMCLK (clock dividers 1), and the duty must stay 3
+// TBCLK away from 0 and TBPRD, where the MEP cannot act (clamped here).
+// The Q8 arithmetic itself is in pwm_hr_calc.h.
+//#############################################################################
+
+#ifndef PWM_HR_H
+#define PWM_HR_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+#include "pwm_hr_calc.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define PWM_HR_MEP_NOMINAL      66U     // Steps per TBCLK at 100 MHz, typical,
+                                        // used until the first calibration
+#define PWM_HR_CAL_PERIOD       64U     // Calibration PWM period, TBCLK
+#define PWM_HR_CAL_AVERAGE      8U      // eCAP runs (2 pulses each) per step
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+// Up-down PWM on channel A
+typedef struct
+{
+    uint32_t  base;
+    bool      hr;                   // MEP enabled
+    uint32_t  tbclkHz;
+    uint32_t  periodQ8;             // TBPRD, 1/256 TBCLK
+    uint32_t  cmpQ8;                // CMPA, 1/256 TBCLK
+    float32_t duty;                 // Requested
+    float32_t freqHz;               // Achieved
+} PwmHr;
+
+// Calibration hardware: a spare ePWM whose A pin (left unconnected) is
+// routed through the input X-BAR to an eCAP
+typedef struct
+{
+    uint32_t      pwmBase;          // e.g. EPWM3_BASE
+    uint32_t      pinConfig;        // e.g. GPIO_4_EPWM3A
+    uint16_t      gpio;             // e.g. 4
+    uint32_t      ecapBase;         // e.g. ECAP1_BASE
+    XBAR_InputNum xbarInput;        // The eCAP's input, XBAR_INPUT7 for eCAP1
+    uint32_t      sysclkHz;         // eCAP time base
+    uint32_t      tbclkHz;          // = EPWMCLK
+} PwmHr_CalConfig;
+
+typedef struct
+{
+    uint16_t  mepScale;             // MEP steps per TBCLK, as in HRMSTEP
+    float32_t stepPs;               // MEP step
+    uint16_t  crossings;            // SYSCLK edges crossed in the last run
+    uint32_t  runs;
+    uint32_t  failures;             // Runs with fewer than 2 crossings
+} PwmHr_Cal;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Take over an up-down PWM already set up (TBPRD, CMPA shadowed and loaded
+// at zero, high on up-count CMPA, low on down-count CMPA). With hr, enable
+// the MEP on both edges with period control and auto-conversion; returns
+// false if TBCLK is divided.
+bool pwm_hr_init(PwmHr *p, uint32_t base, uint32_t tbclkHz, bool hr);
+
+// Frequency of the up-down cycle; the duty is kept. Returns false if the
+// period does not fit 16 bits or leaves no room for the edge margins.
+bool pwm_hr_setFrequency(PwmHr *p, float32_t hz);
+
+// Duty 0..1 (high time / cycle), clamped to the edge margins with HR on.
+void pwm_hr_setDuty(PwmHr *p, float32_t duty);
+
+// Measure the MEP step and write HRMSTEP. Blocking, a few ms. Returns false
+// (HRMSTEP unchanged) if fewer than two SYSCLK crossings were seen.
+bool pwm_hr_calibrate(const PwmHr_CalConfig *cfg, PwmHr_Cal *cal);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_HR_H
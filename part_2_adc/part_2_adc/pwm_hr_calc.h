@@ -0,0 +1,126 @@
+//#############################################################################
+// File: pwm_hr_calc.h
+// Chapter: PWM
+// Code description: register-free arithmetic of pwm_hr.h, kept apart from
+// driverlib so it can be checked on the host (part_2_adc/tools/
+// pwm_hr_calc_test.c). Periods and compare values are in 1/256 TBCLK (Q8):
+// the integer part is TBPRD / CMPA, the fraction TBPRDHR / CMPAHR[15:8],
+// which is what HRPWM_setTimeBasePeriod() / HRPWM_setCounterCompareValue()
+// write from a Q8 value. With HR off both are whole TBCLK.
+//#############################################################################
+
+#ifndef PWM_HR_CALC_H
+#define PWM_HR_CALC_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// As in driverlib's hw_types.h
+#ifndef C2000_IEEE754_TYPES
+#define C2000_IEEE754_TYPES
+#ifdef __TI_EABI__
+typedef float         float32_t;
+typedef double        float64_t;
+#else // TI COFF
+typedef float         float32_t;
+typedef long double   float64_t;
+#endif // __TI_EABI__
+#endif // C2000_IEEE754_TYPES
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define PWM_HR_EDGE_MARGIN      3U      // TBCLK kept from 0 and TBPRD
+
+//---------------------------------------------------------------------------
+// Q8 values
+//---------------------------------------------------------------------------
+// Period of an up-down cycle at hz. Returns false if it does not fit 16 bits
+// or leaves no room for the edge margins. In double precision: a float32
+// quotient is off by more than 1/256 TBCLK near 16-bit periods.
+static inline bool pwm_hr_calcPeriod(uint32_t tbclkHz, float32_t hz, bool hr,
+                                     uint32_t *periodQ8)
+{
+    float64_t q8;
+
+    if (hz <= 0.0f)
+    {
+        return false;
+    }
+    q8 = 128.0 * (float64_t)tbclkHz / (float64_t)hz + 0.5;
+    if ((q8 >= 65536.0 * 256.0) ||
+        (q8 < (float64_t)(4UL * PWM_HR_EDGE_MARGIN * 256UL)))
+    {
+        return false;
+    }
+    *periodQ8 = (uint32_t)q8;
+    if (!hr)
+    {
+        // Whole TBCLK; rounding up may still leave 16 bits
+        *periodQ8 = (*periodQ8 + 128UL) & ~0xFFUL;
+        if (*periodQ8 > 0xFFFFUL << 8)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Compare value for duty 0..1 (clamped), duty = (TBPRD - CMPA) / TBPRD.
+// With HR on it is kept PWM_HR_EDGE_MARGIN from 0 and the period.
+static inline uint32_t pwm_hr_calcCompare(uint32_t periodQ8, float32_t duty,
+                                          bool hr)
+{
+    uint32_t margin = (uint32_t)PWM_HR_EDGE_MARGIN << 8;
+    uint32_t cmpQ8;
+
+    if (duty < 0.0f)
+    {
+        duty = 0.0f;
+    }
+    else if (duty > 1.0f)
+    {
+        duty = 1.0f;
+    }
+
+    cmpQ8 = (uint32_t)((1.0f - duty) * (float32_t)periodQ8 + 0.5f);
+    if (!hr)
+    {
+        return (cmpQ8 + 128UL) & ~0xFFUL;
+    }
+    if (cmpQ8 < margin)
+    {
+        cmpQ8 = margin;
+    }
+    else if (cmpQ8 > periodQ8 - margin)
+    {
+        cmpQ8 = periodQ8 - margin;
+    }
+    return cmpQ8;
+}
+
+//---------------------------------------------------------------------------
+// Register fields of a Q8 value
+//---------------------------------------------------------------------------
+// TBPRD / CMPA
+static inline uint16_t pwm_hr_whole(uint32_t q8)
+{
+    return (uint16_t)(q8 >> 8);
+}
+
+// TBPRDHR / CMPAHR (fraction in bits 15:8)
+static inline uint16_t pwm_hr_fraction(uint32_t q8)
+{
+    return (uint16_t)((q8 & 0xFFUL) << 8);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_HR_CALC_H
@@ -0,0 +1,71 @@
+//#############################################################################
+// File: pwm_timing.h
+// Chapter: PWM
+// Code description: compile-time ePWM timing for up-down (center-aligned)
+// PWMs. All macros are integer-only so they can be used both in code and in
+// #if checks: a configuration that does not fit the hardware is rejected by
+// the preprocessor instead of silently wrapping 16-bit registers, and the
+// init code only writes the precomputed constants.
+//
+// From the PWM frequency f:
+//  - CLKDIV: the smallest power-of-two divider (HSPCLKDIV = 1) whose TBPRD
+//    fits 16 bits, i.e. the finest duty resolution; 8 = unreachable
+//  - TBPRD:  TBCLK / (2 * f), rounded (up-down: one cycle is 2 * TBPRD)
+//  - CMPA:   duty = (TBPRD - CMPA) / TBPRD for high on up-count CMPA and
+//            low on down-count CMPA
+//  - dead band: RED/FED counts in TBCLK, 14 bits
+//
+// Typical checks, next to the configuration:
+//      #if PWM_TIMING_CLKDIV_LOG2(PWM_FREQ) > 7
+//      #error "PWM_FREQ too low"
+//      #endif
+//#############################################################################
+
+#ifndef PWM_TIMING_H
+#define PWM_TIMING_H
+
+#include "device.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define PWM_TIMING_EPWMCLK_HZ   (DEVICE_SYSCLK_FREQ / 2UL)  // EPWMCLKDIV /2 (reset value)
+#define PWM_TIMING_MAX_TBPRD    0xFFFFUL
+#define PWM_TIMING_MIN_TBPRD    2UL     // Leaves room for a compare value inside
+#define PWM_TIMING_MAX_DB       0x3FFFUL
+#define PWM_TIMING_MAX_CLKDIV_LOG2  7   // EPWM_CLOCK_DIVIDER_128
+
+//---------------------------------------------------------------------------
+// Time base
+//---------------------------------------------------------------------------
+// TBPRD at CLKDIV = 2^k, rounded
+#define PWM_TIMING_TBPRD_AT(f, k) \
+    (((PWM_TIMING_EPWMCLK_HZ >> (k)) + (f)) / (2UL * (f)))
+
+#define PWM_TIMING_FITS(f, k)   (PWM_TIMING_TBPRD_AT(f, k) <= PWM_TIMING_MAX_TBPRD)
+
+// log2 of the clock divider: use as (EPWM_ClockDivider)
+#define PWM_TIMING_CLKDIV_LOG2(f)                                           \
+    (PWM_TIMING_FITS(f, 0) ? 0 : PWM_TIMING_FITS(f, 1) ? 1 :                \
+     PWM_TIMING_FITS(f, 2) ? 2 : PWM_TIMING_FITS(f, 3) ? 3 :                \
+     PWM_TIMING_FITS(f, 4) ? 4 : PWM_TIMING_FITS(f, 5) ? 5 :                \
+     PWM_TIMING_FITS(f, 6) ? 6 : PWM_TIMING_FITS(f, 7) ? 7 : 8)
+
+#define PWM_TIMING_TBCLK_HZ(f)  (PWM_TIMING_EPWMCLK_HZ >> PWM_TIMING_CLKDIV_LOG2(f))
+
+#define PWM_TIMING_TBPRD(f)     PWM_TIMING_TBPRD_AT(f, PWM_TIMING_CLKDIV_LOG2(f))
+
+// Frequency actually produced (TBPRD is rounded)
+#define PWM_TIMING_ACTUAL_HZ(f) (PWM_TIMING_TBCLK_HZ(f) / (2UL * PWM_TIMING_TBPRD(f)))
+
+//---------------------------------------------------------------------------
+// Compare and dead band
+//---------------------------------------------------------------------------
+#define PWM_TIMING_CMP(tbprd, dutyPermille) \
+    (((tbprd) * (1000UL - (dutyPermille)) + 500UL) / 1000UL)
+
+// In kHz so that ns * kHz stays in 32 bits (up to 40 us at 100 MHz TBCLK)
+#define PWM_TIMING_DB_COUNTS(ns, tbclkHz) \
+    (((ns) * ((tbclkHz) / 1000UL) + 500000UL) / 1000000UL)
+
+#endif // PWM_TIMING_H
@@ -0,0 +1,159 @@
+//#############################################################################
+// File: pwm_trip.c
+// Chapter: PWM
+// Code description: CMPSS -> X-BAR -> trip zone overcurrent path. See
+// pwm_trip.h.
+//#############################################################################
+
+#include "device.h"
+#include "pwm_trip.h"
+
+#define PWM_TRIP_DAC_MAX        4095U
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+bool pwm_trip_init(PwmTrip *t, const PwmTrip_Config *cfg,
+                   const uint32_t *bases, uint16_t count,
+                   float32_t thresholdMv)
+{
+    uint32_t cmpss = cfg->cmpssBase;
+    uint16_t window = cfg->filterWindow;
+    uint16_t i;
+
+    if ((count == 0U) || (count > PWM_TRIP_MAX))
+    {
+        return false;
+    }
+
+    t->cfg          = cfg;
+    t->count        = count;
+    t->tripped      = false;
+    t->trips        = 0;
+    t->rearms       = 0;
+    t->rearmRefused = 0;
+
+    // Comparator: pin on +, DAC on -, output high above the threshold
+    CMPSS_enableModule(cmpss);
+    CMPSS_configHighComparator(cmpss, CMPSS_INSRC_DAC);
+    CMPSS_configDAC(cmpss, CMPSS_DACREF_VDDA | CMPSS_DACVAL_SYSCLK |
+                    CMPSS_DACSRC_SHDW);
+    CMPSS_setHysteresis(cmpss, cfg->hysteresis);
+    pwm_trip_setThreshold(t, thresholdMv);
+
+    // The filter also feeds the latch read back as telemetry
+    CMPSS_configFilterHigh(cmpss, cfg->filterPrescale,
+                           (window == 0U) ? 1U : window,
+                           (window == 0U) ? 1U : cfg->filterThreshold);
+    CMPSS_initFilterHigh(cmpss);
+    CMPSS_configOutputsHigh(cmpss, (window == 0U) ?
+                            (CMPSS_TRIP_ASYNC_COMP | CMPSS_TRIPOUT_ASYNC_COMP) :
+                            (CMPSS_TRIP_FILTER | CMPSS_TRIPOUT_FILTER));
+    DEVICE_DELAY_US(1);                 // DAC and comparator settling
+    CMPSS_clearFilterLatchHigh(cmpss);
+
+    // CTRIPH -> TRIPn of every ePWM
+    XBAR_setEPWMMuxConfig(cfg->trip, cfg->muxConfig);
+    XBAR_enableEPWMMux(cfg->trip, cfg->mux);
+
+    for (i = 0; i < count; i++)
+    {
+        uint32_t base = bases[i];
+
+        t->base[i] = base;
+
+        // TRIPn high -> DCAEVT1, unsynchronized (no TBCLK wait)
+        EPWM_selectDigitalCompareTripInput(base, cfg->dcInput,
+                                           EPWM_DC_TYPE_DCAH);
+        EPWM_setTripZoneDigitalCompareEventCondition(base, EPWM_TZ_DC_OUTPUT_A1,
+                                                     EPWM_TZ_EVENT_DCXH_HIGH);
+        EPWM_setDigitalCompareEventSource(base, EPWM_DC_MODULE_A,
+                                          EPWM_DC_EVENT_1,
+                                          EPWM_DC_EVENT_SOURCE_ORIG_SIGNAL);
+        EPWM_setDigitalCompareEventSyncMode(base, EPWM_DC_MODULE_A,
+                                            EPWM_DC_EVENT_1,
+                                            EPWM_DC_EVENT_INPUT_NOT_SYNCED);
+
+        // DCAEVT1 as a one-shot trip: both outputs low until cleared
+        EPWM_setTripZoneAction(base, EPWM_TZ_ACTION_EVENT_TZA,
+                               EPWM_TZ_ACTION_LOW);
+        EPWM_setTripZoneAction(base, EPWM_TZ_ACTION_EVENT_TZB,
+                               EPWM_TZ_ACTION_LOW);
+        EPWM_enableTripZoneSignals(base, EPWM_TZ_SIGNAL_DCAEVT1);
+        EPWM_clearOneShotTripZoneFlag(base, EPWM_TZ_OST_FLAG_DCAEVT1);
+        EPWM_clearTripZoneFlag(base, EPWM_TZ_INTERRUPT | EPWM_TZ_FLAG_OST |
+                               EPWM_TZ_FLAG_DCAEVT1);
+    }
+
+    EPWM_enableTripZoneInterrupt(bases[0], EPWM_TZ_INTERRUPT_OST);
+    return true;
+}
+
+void pwm_trip_setThreshold(PwmTrip *t, float32_t thresholdMv)
+{
+    float32_t code = thresholdMv * (float32_t)(PWM_TRIP_DAC_MAX + 1U) /
+                     t->cfg->dacRefMv + 0.5f;
+
+    if (code < 0.0f)
+    {
+        code = 0.0f;
+    }
+    else if (code > (float32_t)PWM_TRIP_DAC_MAX)
+    {
+        code = (float32_t)PWM_TRIP_DAC_MAX;
+    }
+    t->dacCode = (uint16_t)code;
+    CMPSS_setDACValueHigh(t->cfg->cmpssBase, t->dacCode);
+}
+
+//---------------------------------------------------------------------------
+// Trip interrupt
+//---------------------------------------------------------------------------
+// The one-shot flags stay set (outputs held low); only the interrupt flag
+// is cleared so that the next trip after a rearm interrupts again.
+void pwm_trip_onTrip(PwmTrip *t)
+{
+    uint32_t base0 = t->base[0];
+    uint16_t i;
+
+    t->trips++;
+    if (!t->tripped)
+    {
+        t->tripTime = CPUTimer_getTimerCount(PWM_TRIP_TIMESTAMP_BASE);
+        for (i = 0; i < t->count; i++)
+        {
+            t->tbctr[i] = EPWM_getTimeBaseCounterValue(t->base[i]);
+        }
+        t->cmpssStatus = CMPSS_getStatus(t->cfg->cmpssBase);
+        t->tzFlags     = EPWM_getTripZoneFlagStatus(base0);
+        t->ostFlags    = EPWM_getOneShotTripZoneFlagStatus(base0);
+        t->tripped     = true;
+    }
+    EPWM_clearTripZoneFlag(base0, EPWM_TZ_INTERRUPT);
+}
+
+//---------------------------------------------------------------------------
+// Rearm
+//---------------------------------------------------------------------------
+bool pwm_trip_rearm(PwmTrip *t)
+{
+    uint32_t cmpss = t->cfg->cmpssBase;
+    uint16_t i;
+
+    if ((CMPSS_getStatus(cmpss) & CMPSS_STS_HI_FILTOUT) != 0U)
+    {
+        t->rearmRefused++;
+        return false;
+    }
+
+    CMPSS_clearFilterLatchHigh(cmpss);
+    for (i = 0; i < t->count; i++)
+    {
+        EPWM_clearOneShotTripZoneFlag(t->base[i], EPWM_TZ_OST_FLAG_DCAEVT1);
+        EPWM_clearTripZoneFlag(t->base[i], EPWM_TZ_INTERRUPT |
+                               EPWM_TZ_FLAG_OST | EPWM_TZ_FLAG_DCAEVT1);
+    }
+    t->tripped = false;
+    t->rearms++;
+    return true;
+}
@@ -0,0 +1,101 @@
+//#############################################################################
+// File: pwm_trip.h
+// Chapter: PWM
+// Code description: hardware overcurrent trip. A CMPSS high comparator
+// watches an analog input against its 12-bit DAC; its CTRIPH output goes
+// through the ePWM X-BAR to a TRIPIN of the protected ePWMs, where the
+// digital compare block turns it into a one-shot trip zone event (DCAEVT1,
+// unsynchronized) that forces outputs A and B low. No ADC conversion and no
+// CPU are in the path: the outputs are safe tens of ns after the crossing
+// (comparator + X-BAR + trip logic), plus the optional digital filter.
+//
+// The CPU only hears about it afterwards, through the first ePWM's trip
+// zone interrupt, which latches telemetry of the first trip (time, counter
+// positions, CMPSS and trip flags). The outputs stay tripped until
+// pwm_trip_rearm(), which refuses while the comparator is still high.
+//
+// CMPSS positive inputs are fixed pins on F2837xD: CMPSS1 ADCINA2, CMPSS2
+// ADCINA4, CMPSS3 ADCINB2, CMPSS4 ADCINC2, ...
+//#############################################################################
+
+#ifndef PWM_TRIP_H
+#define PWM_TRIP_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#define PWM_TRIP_MAX            4U      // Protected ePWMs
+#define PWM_TRIP_TIMESTAMP_BASE CPUTIMER1_BASE  // Free running (adc_acq.h)
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t           cmpssBase;   // e.g. CMPSS3_BASE
+    XBAR_TripNum       trip;        // e.g. XBAR_TRIP4
+    XBAR_EPWMMuxConfig muxConfig;   // e.g. XBAR_EPWM_MUX04_CMPSS3_CTRIPH
+    uint32_t           mux;         // e.g. XBAR_MUX04
+    EPWM_DigitalCompareTripInput dcInput;   // e.g. EPWM_DC_TRIP_TRIPIN4
+    float32_t          dacRefMv;    // DAC full scale (VDDA reference)
+    uint16_t           hysteresis;  // 0..4 (x 12 DAC codes typical)
+    // Digital filter; window 0 = unfiltered, fastest (async comparator)
+    uint16_t           filterPrescale;  // SYSCLK per sample - 1
+    uint16_t           filterWindow;    // 1..32 samples
+    uint16_t           filterThreshold; // > window / 2
+} PwmTrip_Config;
+
+typedef struct
+{
+    const PwmTrip_Config *cfg;
+    uint16_t  count;
+    uint32_t  base[PWM_TRIP_MAX];   // base[0] raises the interrupt
+    uint16_t  dacCode;              // Threshold
+
+    // Telemetry of the first trip since the last rearm
+    volatile bool tripped;
+    uint32_t  tripTime;             // PWM_TRIP_TIMESTAMP_BASE count (down)
+    uint16_t  tbctr[PWM_TRIP_MAX];  // Counters when the CPU got there
+    uint16_t  cmpssStatus;          // CMPSS_STS_* then
+    uint16_t  tzFlags;              // EPWM_TZ_FLAG_* of base[0]
+    uint16_t  ostFlags;             // EPWM_TZ_OST_FLAG_* of base[0]
+
+    uint32_t  trips;                // Since init
+    uint32_t  rearms;
+    uint32_t  rearmRefused;         // Comparator still high
+} PwmTrip;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Arm the trip path on count ePWMs at thresholdMv. Enables base[0]'s trip
+// zone interrupt (INT_EPWMn_TZ, PIE group 2), whose handler must call
+// pwm_trip_onTrip(). Returns false for 0 or more than PWM_TRIP_MAX bases.
+bool pwm_trip_init(PwmTrip *t, const PwmTrip_Config *cfg,
+                   const uint32_t *bases, uint16_t count,
+                   float32_t thresholdMv);
+
+// Comparator threshold, takes effect on the next SYSCLK
+void pwm_trip_setThreshold(PwmTrip *t, float32_t thresholdMv);
+
+// Call from the trip zone interrupt. Outputs are already safe.
+void pwm_trip_onTrip(PwmTrip *t);
+
+// Release the outputs (they restart on the next PWM edges). Returns false,
+// still tripped, if the input is above the threshold.
+bool pwm_trip_rearm(PwmTrip *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_TRIP_H
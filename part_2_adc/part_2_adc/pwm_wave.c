@@ -0,0 +1,186 @@
+//#############################################################################
+// File: pwm_wave.c
+// Chapter: PWM
+// Code description: DMA-fed CMPA modulation. See pwm_wave.h.
+//#############################################################################
+
+#include <math.h>
+#include "pwm_wave.h"
+
+#define PWM_WAVE_NO_WRAP        0x10000UL   // Wrap size that never wraps
+#define PWM_WAVE_TWO_PI         6.28318531f
+
+//---------------------------------------------------------------------------
+// ePWMn -> DMA trigger (SOCA/SOCB pairs, ePWM modules 0x100 apart)
+//---------------------------------------------------------------------------
+static inline DMA_Trigger socaTrigger(uint32_t pwmBase)
+{
+    return (DMA_Trigger)((uint16_t)DMA_TRIGGER_EPWM1SOCA +
+                         2U * (uint16_t)((pwmBase - EPWM1_BASE) >> 8));
+}
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+bool pwm_wave_init(PwmWave *w, uint32_t pwmBase, uint32_t dmaBase,
+                   uint16_t *storage, uint16_t maxLen, float32_t pwmHz)
+{
+    if (maxLen < 2U)
+    {
+        return false;
+    }
+
+    w->pwmBase    = pwmBase;
+    w->dmaBase    = dmaBase;
+    w->tbprd      = EPWM_getTimeBasePeriod(pwmBase);
+    w->pwmHz      = pwmHz;
+    w->maxLen     = maxLen;
+    w->table[0]   = storage;
+    w->table[1]   = storage + maxLen;
+    w->active     = 0;
+    w->len        = 2;
+    w->pending    = 0;
+    w->pendingLen = 0;
+    w->amplitude  = 0.0f;
+    w->freqHz     = 0.0f;
+    w->achievedHz = 0.0f;
+    w->periods    = 0;
+
+    // Idle at 50 % until the first pwm_wave_set()
+    w->table[0][0] = w->tbprd / 2U;
+    w->table[0][1] = w->tbprd / 2U;
+
+    // DMA on the ePWM registers (peripheral frame 1)
+    SysCtl_selectSecController(SYSCTL_SEC_CONTROLLER_DMA,
+                               SYSCTL_SEC_CONTROLLER_CLA);
+
+    // One word per trigger into the CMPA shadow (high word of CMPA:CMPAHR),
+    // one table per transfer; addresses restart from the shadows each time
+    DMA_configAddresses(dmaBase, (void *)(pwmBase + EPWM_O_CMPA + 1U),
+                        w->table[0]);
+    DMA_configBurst(dmaBase, 1, 0, 0);
+    DMA_configTransfer(dmaBase, w->len, 1, 0);
+    DMA_configWrap(dmaBase, PWM_WAVE_NO_WRAP, 0, PWM_WAVE_NO_WRAP, 0);
+    DMA_configMode(dmaBase, socaTrigger(pwmBase),
+                   DMA_CFG_ONESHOT_DISABLE | DMA_CFG_CONTINUOUS_ENABLE |
+                   DMA_CFG_SIZE_16BIT);
+    DMA_setInterruptMode(dmaBase, DMA_INT_AT_END);
+    DMA_enableTrigger(dmaBase);
+    DMA_enableInterrupt(dmaBase);
+
+    // SOCA at counter = period: the new value is in the shadow before the
+    // load at zero
+    EPWM_setADCTriggerSource(pwmBase, EPWM_SOC_A, EPWM_SOC_TBCTR_PERIOD);
+    EPWM_setADCTriggerEventPrescale(pwmBase, EPWM_SOC_A, 1);
+    EPWM_clearADCTriggerFlag(pwmBase, EPWM_SOC_A);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Build the idle table
+//---------------------------------------------------------------------------
+bool pwm_wave_set(PwmWave *w, const int16_t *shape, uint16_t shapeLen,
+                  float32_t amplitude, float32_t freqHz)
+{
+    uint16_t *dst = w->table[w->active ^ 1U];
+    float32_t half = 0.5f * (float32_t)w->tbprd;
+    float32_t n;
+    uint16_t len;
+    uint16_t i;
+
+    if ((w->pending != 0U) || (freqHz <= 0.0f) ||
+        ((shape != NULL) && (shapeLen == 0U)))
+    {
+        return false;
+    }
+    n = w->pwmHz / freqHz + 0.5f;
+    if ((n < 2.0f) || (n > (float32_t)w->maxLen))
+    {
+        return false;
+    }
+    len = (uint16_t)n;
+
+    for (i = 0; i < len; i++)
+    {
+        float32_t x;
+        float32_t cmp;
+
+        if (shape == NULL)
+        {
+            x = sinf(PWM_WAVE_TWO_PI * (float32_t)i / (float32_t)len);
+        }
+        else
+        {
+            // Linear interpolation over one period of the shape
+            float32_t pos = (float32_t)i * (float32_t)shapeLen /
+                            (float32_t)len;
+            uint16_t k = (uint16_t)pos;
+            uint16_t k1 = (k + 1U < shapeLen) ? k + 1U : 0U;
+            float32_t frac = pos - (float32_t)k;
+
+            x = ((float32_t)shape[k] +
+                 frac * (float32_t)((int32_t)shape[k1] - shape[k])) /
+                32768.0f;
+        }
+
+        // Up-down, high from up-count CMPA to down-count CMPA:
+        // duty = (TBPRD - CMPA) / TBPRD
+        cmp = half - half * amplitude * x + 0.5f;
+        if (cmp < 0.0f)
+        {
+            cmp = 0.0f;
+        }
+        else if (cmp > (float32_t)w->tbprd)
+        {
+            cmp = (float32_t)w->tbprd;
+        }
+        dst[i] = (uint16_t)cmp;
+    }
+
+    w->amplitude  = amplitude;
+    w->freqHz     = freqHz;
+    w->achievedHz = w->pwmHz / (float32_t)len;
+    w->pendingLen = len;
+    w->pending    = 1;
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Run control
+//---------------------------------------------------------------------------
+void pwm_wave_start(PwmWave *w)
+{
+    EPWM_enableADCTrigger(w->pwmBase, EPWM_SOC_A);
+    DMA_startChannel(w->dmaBase);
+}
+
+void pwm_wave_stop(PwmWave *w)
+{
+    EPWM_disableADCTrigger(w->pwmBase, EPWM_SOC_A);
+    DMA_stopChannel(w->dmaBase);
+}
+
+//---------------------------------------------------------------------------
+// End of a waveform period (interrupt context)
+//---------------------------------------------------------------------------
+// The next transfer starts on the next trigger, one carrier period away, and
+// takes its addresses from the shadows; the size register is read then too.
+void pwm_wave_onTransferEnd(PwmWave *w)
+{
+    w->periods++;
+    if (w->pending == 0U)
+    {
+        return;
+    }
+
+    w->active ^= 1U;
+    w->len = w->pendingLen;
+
+    EALLOW;
+    HWREG(w->dmaBase + DMA_O_SRC_BEG_ADDR_SHADOW) = (uint32_t)w->table[w->active];
+    HWREG(w->dmaBase + DMA_O_SRC_ADDR_SHADOW)     = (uint32_t)w->table[w->active];
+    HWREGH(w->dmaBase + DMA_O_TRANSFER_SIZE)      = w->len - 1U;
+    EDIS;
+
+    w->pending = 0;
+}
@@ -0,0 +1,87 @@
+//#############################################################################
+// File: pwm_wave.h
+// Chapter: PWM
+// Code description: DMA-fed waveform player for an up-down ePWM. The PWM's
+// SOCA event (counter = period) triggers a DMA channel that copies the next
+// entry of a compare-value table into the CMPA shadow register, which the
+// ePWM loads at counter = zero: one table entry per carrier period, no CPU
+// work per period. One transfer is one waveform period (the whole table),
+// so the channel interrupts only once per waveform period.
+//
+// The table is built from a sine or from an arbitrary one-period Q15 shape,
+// scaled by the modulation index, with length pwmHz / freqHz. Two tables
+// are used in turn: pwm_wave_set() builds the idle one in the background and
+// the end-of-transfer interrupt switches to it, so amplitude, frequency and
+// shape change at a period boundary without glitches.
+//
+// The DMA reaches the ePWM registers only when it is the secondary master
+// of peripheral frame 1; pwm_wave_init() selects it (the CLA loses access).
+// The table storage must be DMA-accessible (GS RAM).
+//#############################################################################
+
+#ifndef PWM_WAVE_H
+#define PWM_WAVE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t  pwmBase;
+    uint32_t  dmaBase;              // DMA_CHx_BASE
+    uint16_t  tbprd;                // Compare values span 0..tbprd
+    float32_t pwmHz;                // Carrier (table entries per second)
+    uint16_t  maxLen;               // Entries per table
+    uint16_t *table[2];             // storage, storage + maxLen
+
+    uint16_t  active;               // Table being played
+    uint16_t  len;                  // Its length
+    volatile uint16_t pending;      // Idle table ready, switched at the end
+    uint16_t  pendingLen;           // of the current period
+
+    // Current setting (of the last pwm_wave_set())
+    float32_t amplitude;            // Modulation index 0..1
+    float32_t freqHz;               // Requested
+    float32_t achievedHz;           // pwmHz / len
+
+    uint32_t  periods;              // Waveform periods played
+} PwmWave;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Bind an up-down PWM (TBPRD already set, CMPA shadowed and loaded at zero)
+// to a DMA channel, triggered by the PWM's SOCA. storage holds 2 * maxLen
+// words. Call after DMA_initController(); the DMA channel interrupt must
+// call pwm_wave_onTransferEnd(). The output starts at 50 % duty.
+bool pwm_wave_init(PwmWave *w, uint32_t pwmBase, uint32_t dmaBase,
+                   uint16_t *storage, uint16_t maxLen, float32_t pwmHz);
+
+// Build a new waveform: one period of shape (Q15, shapeLen points, NULL for
+// a sine) with modulation index amplitude, at freqHz. Duty = 0.5 + 0.5 *
+// amplitude * shape. Takes effect at the end of the current waveform period.
+// Returns false if the previous update has not been switched in yet, or if
+// freqHz needs more than maxLen or fewer than 2 entries.
+bool pwm_wave_set(PwmWave *w, const int16_t *shape, uint16_t shapeLen,
+                  float32_t amplitude, float32_t freqHz);
+
+void pwm_wave_start(PwmWave *w);
+void pwm_wave_stop(PwmWave *w);
+
+// Call from the DMA channel's interrupt (one per waveform period).
+void pwm_wave_onTransferEnd(PwmWave *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PWM_WAVE_H
@@ -0,0 +1,90 @@
+//#############################################################################
+// File: region_prof.c
+// Chapter: Profiling
+// Code description: code-region cycle accumulation. See region_prof.h.
+//#############################################################################
+
+#include "region_prof.h"
+#include "adc_acq.h"
+
+#if REGION_PROF_ENABLE
+
+//---------------------------------------------------------------------------
+// Globals
+//---------------------------------------------------------------------------
+RegionProf_Block regionProf;
+
+//---------------------------------------------------------------------------
+// Set up
+//---------------------------------------------------------------------------
+void region_prof_init(uint32_t timerBase, uint32_t sysclkHz)
+{
+    uint16_t i;
+
+    regionProf.magic     = REGION_PROF_MAGIC;
+    regionProf.version   = REGION_PROF_VERSION;
+    regionProf.regions   = REGION_PROF_REGIONS;
+    regionProf.reserved  = 0;
+    regionProf.sysclkHz  = sysclkHz;
+    regionProf.timerBase = timerBase;
+    for (i = 0; i < REGION_PROF_REGIONS; i++)
+    {
+        regionProf.region[i].addr = 0;
+    }
+    region_prof_reset();
+
+    adc_acq_startTimestamp(timerBase);
+}
+
+void region_prof_register(uint16_t id, uint32_t addr)
+{
+    if (id < REGION_PROF_REGIONS)
+    {
+        regionProf.region[id].addr = addr;
+    }
+}
+
+void region_prof_reset(void)
+{
+    bool wasDisabled = Interrupt_disableGlobal();
+    uint16_t i;
+
+    for (i = 0; i < REGION_PROF_REGIONS; i++)
+    {
+        RegionProf_Region *r = &regionProf.region[i];
+
+        r->calls     = 0;
+        r->minCycles = 0xFFFFFFFFUL;
+        r->maxCycles = 0;
+        r->totalLo   = 0;
+        r->totalHi   = 0;
+    }
+
+    if (!wasDisabled)
+    {
+        Interrupt_enableGlobal();
+    }
+}
+
+//---------------------------------------------------------------------------
+// Accumulate
+//---------------------------------------------------------------------------
+void region_prof_record(RegionProf_Region *r, uint32_t cycles)
+{
+    r->calls++;
+    r->totalLo += cycles;
+    if (r->totalLo < cycles)
+    {
+        r->totalHi++;
+    }
+    if (cycles < r->minCycles)
+    {
+        r->minCycles = cycles;
+    }
+    if (cycles > r->maxCycles)
+    {
+        r->maxCycles = cycles;
+    }
+}
+
+#endif // REGION_PROF_ENABLE
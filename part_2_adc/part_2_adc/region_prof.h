@@ -0,0 +1,124 @@
+//#############################################################################
+// File: region_prof.h
+// Chapter: Profiling
+// Code description: cycle profiler for named code regions (ISR bodies,
+// processing stages, copy loops). A region is bracketed by REGION_PROF_BEGIN
+// and REGION_PROF_END, which stamp a free-running CPU timer, and accumulates
+// calls, total/min/max cycles in one fixed RAM block ("regionProf"). Each
+// region is named by a code address (normally the function it profiles), so
+// the block can be saved from the debugger (Memory Browser -> Save Memory,
+// TI hex format, from &regionProf, sizeof(regionProf) words) and turned
+// into a per-function table against the linker .map file by the host tool
+// part_2_adc/tools/region_prof_report.py.
+//
+// The F2837xD has no ERAD, so regions cost two timer reads and a few adds
+// instead of being counted by hardware; keep them around code that runs
+// for hundreds of cycles or more. The timer may be shared with other
+// timestamp users (adc_acq, isr_prof).
+//
+// Build with REGION_PROF_ENABLE = 0 (project predefined symbol) to compile
+// the regions out.
+//#############################################################################
+
+#ifndef REGION_PROF_H
+#define REGION_PROF_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+#ifndef REGION_PROF_ENABLE
+#define REGION_PROF_ENABLE      1
+#endif
+
+// Marks the start of the block in a raw memory dump ("RP")
+#define REGION_PROF_MAGIC       0x5250U
+#define REGION_PROF_VERSION     1U
+#define REGION_PROF_REGIONS     8U
+
+// Code address of a function, for region_prof_register()
+#define REGION_PROF_ADDR(fn)    ((uint32_t)&(fn))
+
+#if REGION_PROF_ENABLE
+
+//---------------------------------------------------------------------------
+// Profile block (all 32-bit fields, read back by the host tool)
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t addr;                  // Names the region (.map), 0 = unused
+    uint32_t start;                 // Timer count at the last begin
+    uint32_t calls;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint32_t totalLo;               // 64-bit total cycles
+    uint32_t totalHi;
+} RegionProf_Region;
+
+typedef struct
+{
+    uint16_t magic;                 // REGION_PROF_MAGIC
+    uint16_t version;               // REGION_PROF_VERSION
+    uint16_t regions;
+    uint16_t reserved;
+    uint32_t sysclkHz;              // Timer clock, for the report
+    uint32_t timerBase;
+    RegionProf_Region region[REGION_PROF_REGIONS];
+} RegionProf_Block;
+
+extern RegionProf_Block regionProf;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Clear the block; timerBase must count down at sysclkHz, it is made
+// free running with adc_acq_startTimestamp().
+void region_prof_init(uint32_t timerBase, uint32_t sysclkHz);
+
+// Name region id after a code address, e.g. REGION_PROF_ADDR(decim_process)
+void region_prof_register(uint16_t id, uint32_t addr);
+
+// Clear all counts (names kept)
+void region_prof_reset(void);
+
+void region_prof_record(RegionProf_Region *r, uint32_t cycles);
+
+static inline void region_prof_begin(uint16_t id)
+{
+    regionProf.region[id].start = HWREG(regionProf.timerBase + CPUTIMER_O_TIM);
+}
+
+static inline void region_prof_end(uint16_t id)
+{
+    // The timer counts down
+    region_prof_record(&regionProf.region[id], regionProf.region[id].start -
+                       HWREG(regionProf.timerBase + CPUTIMER_O_TIM));
+}
+
+#define REGION_PROF_INIT(base, hz)      region_prof_init((base), (hz))
+#define REGION_PROF_REGISTER(id, addr)  region_prof_register((id), (addr))
+#define REGION_PROF_BEGIN(id)           region_prof_begin(id)
+#define REGION_PROF_END(id)             region_prof_end(id)
+
+#else
+
+#define REGION_PROF_INIT(base, hz)
+#define REGION_PROF_REGISTER(id, addr)
+#define REGION_PROF_BEGIN(id)
+#define REGION_PROF_END(id)
+
+#endif // REGION_PROF_ENABLE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // REGION_PROF_H
@@ -0,0 +1,73 @@
+//#############################################################################
+// File: sample_clock.c
+// Chapter: ADC / ePWM
+// Code description: PWM-synchronous ADC trigger. See sample_clock.h.
+//#############################################################################
+
+#include "sample_clock.h"
+
+//---------------------------------------------------------------------------
+// Configure the sample clock ePWM
+//---------------------------------------------------------------------------
+bool sample_clock_init(SampleClock *sc, uint32_t pwmBase, uint32_t clkBase,
+                       uint32_t cycleTbclk, uint16_t samplesPerCycle,
+                       uint16_t pointTbclk, uint32_t tbclkHz)
+{
+    uint32_t slot;
+
+    if ((samplesPerCycle == 0U) || ((cycleTbclk % samplesPerCycle) != 0U))
+    {
+        return false;
+    }
+    slot = cycleTbclk / samplesPerCycle;
+    // TBPRD = slot - 1 would take 65536, but slotTbclk holds only 16 bits
+    if ((slot <= SAMPLE_CLOCK_SYNC_DELAY) || (slot > 0xFFFFUL))
+    {
+        return false;
+    }
+
+    sc->pwmBase         = pwmBase;
+    sc->clkBase         = clkBase;
+    sc->cycleTbclk      = cycleTbclk;
+    sc->samplesPerCycle = samplesPerCycle;
+    sc->slotTbclk       = (uint16_t)slot;
+    sc->achievedHz      = (float32_t)tbclkHz / (float32_t)slot;
+
+    // Master: sync pulse at the start of every PWM cycle
+    EPWM_setSyncOutPulseMode(pwmBase, EPWM_SYNC_OUT_PULSE_ON_COUNTER_ZERO);
+
+    // Slave: up-count, one period per sample, restarted by every sync. The
+    // slot divides the cycle exactly, so the reload only removes drift and
+    // never shortens a slot.
+    EPWM_setTimeBasePeriod(clkBase, (uint16_t)(slot - 1U));
+    EPWM_setTimeBaseCounter(clkBase, 0);
+    EPWM_setTimeBaseCounterMode(clkBase, EPWM_COUNTER_MODE_UP);
+    EPWM_setPhaseShift(clkBase, SAMPLE_CLOCK_SYNC_DELAY);
+    EPWM_setCountModeAfterSync(clkBase, EPWM_COUNT_MODE_UP_AFTER_SYNC);
+    EPWM_enablePhaseShiftLoad(clkBase);
+    EPWM_setSyncOutPulseMode(clkBase, EPWM_SYNC_OUT_PULSE_ON_EPWMxSYNCIN);
+
+    // SOCA at CTR = CMPC on the way up, every event
+    EPWM_setCounterCompareShadowLoadMode(clkBase, EPWM_COUNTER_COMPARE_C,
+                                         EPWM_COMP_LOAD_ON_CNTR_ZERO);
+    sample_clock_setPoint(sc, pointTbclk);
+    EPWM_setADCTriggerSource(clkBase, EPWM_SOC_A, EPWM_SOC_TBCTR_U_CMPC);
+    EPWM_setADCTriggerEventPrescale(clkBase, EPWM_SOC_A, 1);
+    EPWM_enableADCTrigger(clkBase, EPWM_SOC_A);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Move the sampling point
+//---------------------------------------------------------------------------
+void sample_clock_setPoint(SampleClock *sc, uint16_t pointTbclk)
+{
+    if (pointTbclk >= sc->slotTbclk)
+    {
+        pointTbclk = sc->slotTbclk - 1U;
+    }
+    sc->pointTbclk = pointTbclk;
+    EPWM_setCounterCompareValue(sc->clkBase, EPWM_COUNTER_COMPARE_C,
+                                pointTbclk);
+}
@@ -0,0 +1,70 @@
+//#############################################################################
+// File: sample_clock.h
+// Chapter: ADC / ePWM
+// Code description: ADC sample clock phase-locked to a PWM waveform. A
+// second ePWM ("sample clock") runs at an integer multiple of the PWM
+// frequency, is re-synchronised by the PWM's SYNCOUT at the start of every
+// PWM cycle, and raises SOCA at a programmable point inside each sample
+// slot. The ADC is triggered from that SOCA, so every sample sits at the
+// same place of the PWM cycle from one cycle to the next: no drift against
+// the waveform, coherent averaging over cycles is possible, and no CPU
+// timer is used.
+//
+// On the F2837xD the sync chain is fixed EPWM1 -> EPWM2 -> EPWM3, so the
+// sample clock ePWM is the one directly after the PWM in the chain.
+//#############################################################################
+
+#ifndef SAMPLE_CLOCK_H
+#define SAMPLE_CLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "driverlib.h"
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// TBCLK cycles between the master's CTR = 0 and the phase load in the
+// slave; loaded into TBPHS so the slave counter lines up exactly.
+#define SAMPLE_CLOCK_SYNC_DELAY     2U
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    uint32_t pwmBase;           // PWM the samples lock to (sync master)
+    uint32_t clkBase;           // Sample clock ePWM (sync slave)
+    uint32_t cycleTbclk;        // One PWM cycle in TBCLK
+    uint16_t samplesPerCycle;
+    uint16_t slotTbclk;         // TBCLK per sample
+    uint16_t pointTbclk;        // Sampling point inside each slot
+    float32_t achievedHz;       // Sample rate, from tbclkHz
+} SampleClock;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Set up clkBase to raise SOCA samplesPerCycle times per PWM cycle of
+// cycleTbclk TBCLK (2 * TBPRD in up-down mode, TBPRD + 1 in up mode).
+// Sample k of each cycle is taken pointTbclk + k * slot after the PWM's
+// CTR = 0. Both ePWMs must use the same TBCLK prescaler; call while
+// TBCLKSYNC is off. Returns false (nothing configured) if the cycle is not
+// an exact multiple of the slot or the slot does not fit the counter.
+bool sample_clock_init(SampleClock *sc, uint32_t pwmBase, uint32_t clkBase,
+                       uint32_t cycleTbclk, uint16_t samplesPerCycle,
+                       uint16_t pointTbclk, uint32_t tbclkHz);
+
+// Move the sampling point inside the slot (takes effect next slot).
+void sample_clock_setPoint(SampleClock *sc, uint16_t pointTbclk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SAMPLE_CLOCK_H
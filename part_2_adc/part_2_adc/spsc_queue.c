@@ -0,0 +1,90 @@
+//#############################################################################
+// File: spsc_queue.c
+// Chapter: DMA / ADC
+// Code description: lock-free SPSC word ring, block copies. See spsc_queue.h.
+//#############################################################################
+
+#include "spsc_queue.h"
+
+//---------------------------------------------------------------------------
+// Build an empty ring
+//---------------------------------------------------------------------------
+bool spsc_init(SPSCQueue *q, uint16_t *storage, uint16_t size)
+{
+    // Power of two, 1 .. SPSC_QUEUE_MAX_SIZE
+    if ((size == 0U) || (size > SPSC_QUEUE_MAX_SIZE) ||
+        ((size & (uint16_t)(size - 1U)) != 0U))
+    {
+        return false;
+    }
+
+    q->buf  = storage;
+    q->mask = (uint16_t)(size - 1U);
+    q->head = 0;
+    q->tail = 0;
+    spsc_resetStats(q);
+    return true;
+}
+
+//---------------------------------------------------------------------------
+// Producer side
+//---------------------------------------------------------------------------
+uint16_t spsc_pushBlock(SPSCQueue *q, const uint16_t *src, uint16_t n)
+{
+    uint16_t head  = q->head;
+    uint16_t level = (uint16_t)(head - q->tail);
+    uint16_t space = (uint16_t)(q->mask + 1U - level);
+    uint16_t i;
+
+    if (n > space)
+    {
+        q->dropped += n - space;
+        n = space;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        q->buf[(uint16_t)(head + i) & q->mask] = src[i];
+    }
+    q->head = (uint16_t)(head + n);     // Publish after the data
+    q->pushed += n;
+
+    level += n;
+    if (level > q->highWater)
+    {
+        q->highWater = level;
+    }
+    return n;
+}
+
+//---------------------------------------------------------------------------
+// Consumer side
+//---------------------------------------------------------------------------
+uint16_t spsc_popBlock(SPSCQueue *q, uint16_t *dst, uint16_t n)
+{
+    uint16_t tail  = q->tail;
+    uint16_t level = (uint16_t)(q->head - tail);
+    uint16_t i;
+
+    if (n > level)
+    {
+        n = level;
+    }
+
+    for (i = 0; i < n; i++)
+    {
+        dst[i] = q->buf[(uint16_t)(tail + i) & q->mask];
+    }
+    q->tail = (uint16_t)(tail + n);     // Free the slots after the reads
+    return n;
+}
+
+//---------------------------------------------------------------------------
+// Statistics
+//---------------------------------------------------------------------------
+void spsc_resetStats(SPSCQueue *q)
+{
+    q->highWater = spsc_count(q);
+    q->pushed    = 0;
+    q->dropped   = 0;
+}
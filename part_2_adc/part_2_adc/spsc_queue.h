@@ -0,0 +1,127 @@
+//#############################################################################
+// File: spsc_queue.h
+// Chapter: DMA / ADC
+// Code description: lock-free single-producer/single-consumer ring of 16-bit
+// words, for handing samples or block indices from an ISR to the main loop
+// (or the other way round).
+//
+// head and tail are free-running 16-bit counters: only the producer writes
+// head, only the consumer writes tail, and both are single-word stores, so
+// they are atomic on the C28x and no interrupt masking is needed. The ring
+// size is a power of two, the fill level is simply (head - tail) modulo 2^16
+// and every slot is usable.
+//
+// The producer also keeps a high-water mark and a count of items it had to
+// drop because the ring was full.
+//#############################################################################
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//---------------------------------------------------------------------------
+// Defines
+//---------------------------------------------------------------------------
+// Largest ring; sizes must be a power of two so that (head - tail) never
+// wraps past the ring.
+#define SPSC_QUEUE_MAX_SIZE     0x8000U
+
+//---------------------------------------------------------------------------
+// Types
+//---------------------------------------------------------------------------
+typedef struct
+{
+    volatile uint16_t *buf;
+    uint16_t mask;                  // size - 1
+    volatile uint16_t head;         // Next slot to write (producer only)
+    volatile uint16_t tail;         // Next slot to read (consumer only)
+
+    // Statistics (producer side)
+    uint16_t highWater;             // Peak fill level since init/reset
+    uint32_t pushed;                // Items accepted
+    uint32_t dropped;               // Items refused: ring full
+} SPSCQueue;
+
+//---------------------------------------------------------------------------
+// Function Prototypes
+//---------------------------------------------------------------------------
+// Use storage (size words, size a power of two up to SPSC_QUEUE_MAX_SIZE) as
+// an empty ring. Returns false if size is not a valid ring size.
+bool spsc_init(SPSCQueue *q, uint16_t *storage, uint16_t size);
+
+// Producer: copy up to n words in, return the number accepted. The rest are
+// counted as dropped.
+uint16_t spsc_pushBlock(SPSCQueue *q, const uint16_t *src, uint16_t n);
+
+// Consumer: copy up to n words out, return the number read.
+uint16_t spsc_popBlock(SPSCQueue *q, uint16_t *dst, uint16_t n);
+
+// Clear highWater/pushed/dropped. These belong to the producer: call from
+// the producer context, or while it cannot run.
+void spsc_resetStats(SPSCQueue *q);
+
+//---------------------------------------------------------------------------
+// Inline accessors (cheap enough for a per-sample ISR)
+//---------------------------------------------------------------------------
+// Items waiting; exact for the consumer, a lower bound for the producer.
+static inline uint16_t spsc_count(const SPSCQueue *q)
+{
+    return (uint16_t)(q->head - q->tail);
+}
+
+static inline uint16_t spsc_size(const SPSCQueue *q)
+{
+    return (uint16_t)(q->mask + 1U);
+}
+
+// Producer: append one word, or count a drop if the ring is full.
+static inline bool spsc_push(SPSCQueue *q, uint16_t v)
+{
+    uint16_t head  = q->head;
+    uint16_t level = (uint16_t)(head - q->tail);
+
+    if (level > q->mask)
+    {
+        q->dropped++;
+        return false;
+    }
+
+    q->buf[head & q->mask] = v;
+    q->head = (uint16_t)(head + 1U);    // Publish after the data
+    q->pushed++;
+
+    level++;
+    if (level > q->highWater)
+    {
+        q->highWater = level;
+    }
+    return true;
+}
+
+// Consumer: remove the oldest word, false if the ring is empty.
+static inline bool spsc_pop(SPSCQueue *q, uint16_t *v)
+{
+    uint16_t tail = q->tail;
+
+    if (tail == q->head)
+    {
+        return false;
+    }
+
+    *v = q->buf[tail & q->mask];
+    q->tail = (uint16_t)(tail + 1U);    // Free the slot after the read
+    return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPSC_QUEUE_H
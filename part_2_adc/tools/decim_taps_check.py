@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+#############################################################################
+# File: decim_taps_check.py
+# Chapter: ADC
+# Code description: host check of the built-in decimation filters in
+# part_2_adc/decim.c against what decim.h promises: Q15 taps summing to
+# exactly 32768 (DC gain 1), symmetric (linear phase), passband flatness
+# and stopband attenuation. decimCic3Comp is checked together with the
+# order-3 CIC in front of it, at the smallest and a typical ratio.
+#
+# Usage (from part_2_adc): python3 tools/decim_taps_check.py [decim.c]
+#############################################################################
+
+import math
+import os
+import re
+import sys
+
+GRID = 4000                 # Frequency points over 0 .. fs/2
+
+# name, CIC ratios to combine with (None = FIR alone),
+# passband edge and max deviation (dB), stopband edge and min attenuation
+SPECS = [
+    ("decimLowpass5", [None], 0.075, 0.05, 0.125, 54.0),
+    ("decimCic3Comp", [8, 20], 0.15, 0.05, 0.32, 59.0),
+]
+
+
+def read_taps(path, name):
+    with open(path) as f:
+        text = f.read()
+    m = re.search(name + r"\s*\[\w+\]\s*=\s*\{(.*?)\};", text, re.S)
+    if not m:
+        sys.exit("%s not found in %s" % (name, path))
+    return [int(t) for t in m.group(1).replace("\n", " ").split(",")
+            if t.strip()]
+
+
+def fir_gain(taps, f):
+    re_ = sum(h * math.cos(2.0 * math.pi * f * n) for n, h in enumerate(taps))
+    im = sum(h * math.sin(2.0 * math.pi * f * n) for n, h in enumerate(taps))
+    return math.hypot(re_, im) / 32768.0
+
+
+def cic_gain(f, ratio, order=3):
+    """Order-N CIC, f relative to its output rate, DC gain 1."""
+    if f == 0.0:
+        return 1.0
+    return abs(math.sin(math.pi * f) /
+               (ratio * math.sin(math.pi * f / ratio))) ** order
+
+
+def db(x):
+    return 20.0 * math.log10(max(x, 1e-12))
+
+
+def check(path, name, ratios, f_pass, max_dev, f_stop, min_att):
+    taps = read_taps(path, name)
+    ok = True
+
+    if sum(taps) != 32768:
+        print("FAIL %s: taps sum to %d, not 32768" % (name, sum(taps)))
+        ok = False
+    if taps != taps[::-1]:
+        print("FAIL %s: taps not symmetric" % name)
+        ok = False
+
+    freqs = [0.5 * i / GRID for i in range(GRID + 1)]
+    for ratio in ratios:
+        label = name if ratio is None else "%s + CIC3 R=%d" % (name, ratio)
+        gain = [fir_gain(taps, f) * (1.0 if ratio is None
+                                     else cic_gain(f, ratio)) for f in freqs]
+        dev = max(abs(db(g)) for f, g in zip(freqs, gain) if f <= f_pass)
+        att = -max(db(g) for f, g in zip(freqs, gain) if f >= f_stop)
+        status = "ok" if (dev <= max_dev and att >= min_att) else "FAIL"
+        print("%-4s %-28s passband %.3f dB to %.3f fs, "
+              "stopband -%.1f dB from %.3f fs" %
+              (status, label, dev, f_pass, att, f_stop))
+        ok = ok and status == "ok"
+    return ok
+
+
+def main():
+    here = os.path.dirname(os.path.abspath(__file__))
+    path = sys.argv[1] if len(sys.argv) > 1 else \
+        os.path.join(here, "..", "part_2_adc", "decim.c")
+
+    results = [check(path, *spec) for spec in SPECS]
+    print("PASS" if all(results) else "FAILED")
+    sys.exit(0 if all(results) else 1)
+
+
+if __name__ == "__main__":
+    main()
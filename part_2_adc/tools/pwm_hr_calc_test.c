@@ -0,0 +1,141 @@
+//#############################################################################
+// File: pwm_hr_calc_test.c
+// Chapter: PWM
+// Code description: host check of pwm_hr_calc.h against an exact (double)
+// model. For several frequencies it checks TBPRD:TBPRDHR, then CMPA:CMPAHR
+// at the boundary duties (0, 1 Q8 LSB, 50%, 1 - 1 LSB, 1), with HR on
+// and off:
+//  - Q8 values within 1/256 TBCLK of the exact ones with HR on, and with
+//    HR off whole TBCLK within half a TBCLK of them
+//  - compare values inside the edge margins with HR on
+//  - register fields that put the Q8 value back together
+//  - out-of-range frequencies rejected, including a period that only
+//    overflows once rounded to whole TBCLK
+//
+// Build and run from part_2_adc:
+//   gcc -std=c99 -Wall -Ipart_2_adc tools/pwm_hr_calc_test.c -lm
+//       -o /tmp/pwm_hr_calc_test && /tmp/pwm_hr_calc_test
+//#############################################################################
+
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "pwm_hr_calc.h"
+
+#define TBCLK_HZ        100000000UL     // EPWMCLK, dividers 1
+
+static int failures = 0;
+
+static void fail(const char *what, double hz, double duty, bool hr,
+                 double got, double expected)
+{
+    printf("FAIL %s: %.3f Hz duty %.9f hr %d: %.3f, expected %.3f\n",
+           what, hz, duty, hr, got, expected);
+    failures++;
+}
+
+static void checkDuty(uint32_t periodQ8, double hz, double duty, bool hr)
+{
+    uint32_t cmpQ8 = pwm_hr_calcCompare(periodQ8, (float32_t)duty, hr);
+    double margin = 256.0 * PWM_HR_EDGE_MARGIN;
+    double exact;
+
+    // Exact compare for the (already checked) period, clamped like the code
+    exact = (1.0 - duty) * (double)periodQ8;
+    if (hr)
+    {
+        exact = fmin(fmax(exact, margin), (double)periodQ8 - margin);
+        if (fabs((double)cmpQ8 - exact) > 1.0)
+        {
+            fail("CMPA:CMPAHR", hz, duty, hr, cmpQ8, exact);
+        }
+        if (((double)cmpQ8 < margin) ||
+            ((double)cmpQ8 > (double)periodQ8 - margin))
+        {
+            fail("edge margin", hz, duty, hr, cmpQ8, margin);
+        }
+    }
+    else if (((cmpQ8 & 0xFFU) != 0U) ||
+             (fabs((double)cmpQ8 - exact) > 128.0 + 1.0))
+    {
+        fail("CMPA", hz, duty, hr, cmpQ8, exact);
+    }
+
+    if ((((uint32_t)pwm_hr_whole(cmpQ8) << 8) |
+         (pwm_hr_fraction(cmpQ8) >> 8)) != cmpQ8)
+    {
+        fail("CMPA fields", hz, duty, hr, cmpQ8, cmpQ8);
+    }
+}
+
+static void checkFrequency(double hz, bool hr)
+{
+    double exact = 128.0 * TBCLK_HZ / (double)(float32_t)hz;  // As passed
+    double lsb;
+    uint32_t periodQ8;
+
+    if (!pwm_hr_calcPeriod(TBCLK_HZ, (float32_t)hz, hr, &periodQ8))
+    {
+        fail("rejected", hz, 0.0, hr, 0.0, exact);
+        return;
+    }
+
+    if (hr ? (fabs((double)periodQ8 - exact) > 1.0)
+           : (((periodQ8 & 0xFFU) != 0U) ||
+              (fabs((double)periodQ8 - exact) > 128.0 + 1.0)))
+    {
+        fail("TBPRD:TBPRDHR", hz, 0.0, hr, periodQ8, exact);
+    }
+    if ((((uint32_t)pwm_hr_whole(periodQ8) << 8) |
+         (pwm_hr_fraction(periodQ8) >> 8)) != periodQ8)
+    {
+        fail("TBPRD fields", hz, 0.0, hr, periodQ8, periodQ8);
+    }
+
+    lsb = 1.0 / (double)periodQ8;
+    checkDuty(periodQ8, hz, 0.0, hr);
+    checkDuty(periodQ8, hz, lsb, hr);
+    checkDuty(periodQ8, hz, 0.5, hr);
+    checkDuty(periodQ8, hz, 1.0 - lsb, hr);
+    checkDuty(periodQ8, hz, 1.0, hr);
+}
+
+static void checkRejected(double hz, bool hr)
+{
+    uint32_t periodQ8;
+
+    if (pwm_hr_calcPeriod(TBCLK_HZ, (float32_t)hz, hr, &periodQ8))
+    {
+        fail("accepted", hz, 0.0, hr, periodQ8, 0.0);
+    }
+}
+
+int main(void)
+{
+    static const double freqs[] =
+    {
+        763.0,          // TBPRD just under 16 bits
+        1000.0,
+        12345.678,
+        100000.0,
+        333333.333,     // Fractional period
+        4000000.0,      // Shortest period the margins allow
+    };
+    uint16_t i;
+
+    for (i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++)
+    {
+        checkFrequency(freqs[i], true);
+        checkFrequency(freqs[i], false);
+    }
+
+    checkRejected(0.0, true);
+    checkRejected(-1000.0, true);
+    checkRejected(762.0, true);         // TBPRD over 16 bits
+    checkRejected(762.94, false);       // 65535.7 TBCLK: rounds to 65536
+    checkRejected(5000000.0, true);     // 10 TBCLK, inside the edge margins
+
+    printf("%s\n", (failures == 0) ? "PASS" : "FAILED");
+    return (failures == 0) ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+#############################################################################
+# File: region_prof_report.py
+# Chapter: Profiling
+# Code description: host side of region_prof.h. Reads a memory dump of the
+# "regionProf" block saved from CCS (Memory Browser -> Save Memory, TI hex
+# format, 16- or 32-bit words, starting at &regionProf) and the linker .map
+# file, and prints one row per profiled function: calls, total, mean, min
+# and max cycles, share of the profiled total and mean time.
+#
+# Usage: region_prof_report.py <dump.dat> <project.map> [--sysclk HZ]
+#############################################################################
+
+import argparse
+import bisect
+import re
+import sys
+
+MAGIC = 0x5250
+VERSION = 1
+HEADER_WORDS = 8            # magic, version, regions, reserved, sysclk, timer
+REGION_WORDS = 14           # 7 x 32-bit fields
+
+
+def read_dump(path):
+    """16-bit words of a CCS TI hex dump (or a plain list of hex numbers)."""
+    words = []
+    with open(path) as f:
+        lines = f.read().split("\n")
+    if lines and lines[0].split()[:1] == ["1651"]:
+        lines = lines[1:]                       # MagicNumber Format Addr Page Len
+    for tok in " ".join(lines).split():
+        text = tok[2:] if tok.lower().startswith("0x") else tok
+        value = int(text, 16)
+        if len(text) > 4:                       # 32-bit save: low word first
+            words.append(value & 0xFFFF)
+            words.append(value >> 16)
+        else:
+            words.append(value)
+    return words
+
+
+def read_map(path):
+    """Sorted (address, name) of the code symbols (page 0) in a .map file."""
+    symbols = []
+    in_table = False
+    row = re.compile(r"^\s*(?:(\d+)\s+)?([0-9a-fA-F]{8})\s+(\S+)\s*$")
+    with open(path) as f:
+        for line in f:
+            if line.startswith("GLOBAL SYMBOLS: SORTED BY Symbol Address"):
+                in_table = True
+                continue
+            if in_table and line.startswith("[") and "symbols]" in line:
+                break
+            m = row.match(line) if in_table else None
+            if m and (m.group(1) in (None, "0")):
+                symbols.append((int(m.group(2), 16), m.group(3)))
+    symbols.sort()
+    return symbols
+
+
+def name_of(symbols, addr):
+    i = bisect.bisect_right([a for a, _ in symbols], addr) - 1
+    if i < 0:
+        return "0x%08x" % addr
+    base, name = symbols[i]
+    return name if base == addr else "%s+0x%x" % (name, addr - base)
+
+
+def u32(words, i):
+    return words[i] | (words[i + 1] << 16)
+
+
+def decode(words):
+    for start in range(len(words) - HEADER_WORDS):
+        if words[start] == MAGIC and words[start + 1] == VERSION:
+            break
+    else:
+        sys.exit("no region profile block (magic 0x%04x) in the dump" % MAGIC)
+
+    count = words[start + 2]
+    sysclk = u32(words, start + 4)
+    regions = []
+    for r in range(count):
+        i = start + HEADER_WORDS + r * REGION_WORDS
+        if i + REGION_WORDS > len(words):
+            sys.exit("dump too short for %d regions" % count)
+        addr = u32(words, i)
+        calls = u32(words, i + 4)
+        if addr == 0 or calls == 0:
+            continue
+        total = u32(words, i + 10) | (u32(words, i + 12) << 32)
+        regions.append((addr, calls, total, u32(words, i + 6),
+                        u32(words, i + 8)))
+    return sysclk, regions
+
+
+def main():
+    ap = argparse.ArgumentParser(
+        description="Per-function cycle table from a regionProf dump")
+    ap.add_argument("dump")
+    ap.add_argument("map")
+    ap.add_argument("--sysclk", type=int, help="override the block's SYSCLK")
+    args = ap.parse_args()
+
+    sysclk, regions = decode(read_dump(args.dump))
+    if args.sysclk:
+        sysclk = args.sysclk
+    symbols = read_map(args.map)
+    grand = sum(r[2] for r in regions) or 1
+
+    print("%-32s %10s %14s %6s %10s %10s %10s %10s" %
+          ("function", "calls", "total cyc", "%", "mean cyc", "min cyc",
+           "max cyc", "mean us"))
+    for addr, calls, total, lo, hi in sorted(regions, key=lambda r: -r[2]):
+        mean = total / calls
+        print("%-32s %10d %14d %6.1f %10.1f %10d %10d %10.3f" %
+              (name_of(symbols, addr), calls, total, 100.0 * total / grand,
+               mean, lo, hi, 1e6 * mean / sysclk if sysclk else 0.0))
+
+
+if __name__ == "__main__":
+    main()
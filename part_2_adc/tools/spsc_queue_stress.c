@@ -0,0 +1,159 @@
+//#############################################################################
+// File: spsc_queue_stress.c
+// Chapter: DMA / ADC
+// Code description: host stress test of spsc_queue (part_2_adc copy; the
+// part_1_dma one is identical). A producer thread and a consumer thread
+// move a 16-bit sequence through a small ring, mixing single-word and block
+// calls, so head and tail wrap around 2^16 many times. The consumer checks
+// that every word arrives once, in order; the producer retries refused words,
+// and the counters must add up at the end.
+//
+// Needs a host that keeps stores in program order (x86), like the
+// single-core C28x the queue is written for.
+//
+// Build and run from part_2_adc:
+//   gcc -std=gnu99 -O2 -Wall -pthread -Ipart_2_adc tools/spsc_queue_stress.c
+//       part_2_adc/spsc_queue.c -o /tmp/spsc_stress && /tmp/spsc_stress
+//#############################################################################
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "spsc_queue.h"
+
+#define RING_SIZE       16U
+#define TOTAL_WORDS     4000000UL   // About 60 wraps of the 16-bit indices
+#define MAX_BLOCK       7U          // Block calls of 1..7 words
+
+static SPSCQueue queue;
+static uint16_t storage[RING_SIZE];
+static uint32_t refused;            // Producer: words to be retried
+
+// Small deterministic generator for the call mix
+static uint32_t nextRandom(uint32_t *state)
+{
+    *state = *state * 1664525UL + 1013904223UL;
+    return *state >> 16;
+}
+
+static void *producer(void *arg)
+{
+    uint32_t sent = 0;
+    uint32_t rnd = 1;
+    uint16_t block[MAX_BLOCK];
+    uint16_t n;
+    uint16_t i;
+
+    (void)arg;
+    while (sent < TOTAL_WORDS)
+    {
+        if ((nextRandom(&rnd) & 1U) != 0U)
+        {
+            if (spsc_push(&queue, (uint16_t)sent))
+            {
+                sent++;
+            }
+            else
+            {
+                refused++;
+                sched_yield();      // Full: let the consumer run
+            }
+            continue;
+        }
+
+        n = (uint16_t)(1U + nextRandom(&rnd) % MAX_BLOCK);
+        if (n > TOTAL_WORDS - sent)
+        {
+            n = (uint16_t)(TOTAL_WORDS - sent);
+        }
+        for (i = 0; i < n; i++)
+        {
+            block[i] = (uint16_t)(sent + i);
+        }
+        i = spsc_pushBlock(&queue, block, n);
+        refused += n - i;
+        sent += i;
+        if (i < n)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t thread;
+    uint32_t received = 0;
+    uint32_t errors = 0;
+    uint32_t rnd = 7;
+    uint16_t block[MAX_BLOCK];
+    uint16_t n;
+    uint16_t i;
+
+    if (!spsc_init(&queue, storage, RING_SIZE))
+    {
+        printf("FAIL spsc_init\n");
+        return 1;
+    }
+    pthread_create(&thread, NULL, producer, NULL);
+
+    while (received < TOTAL_WORDS)
+    {
+        if ((nextRandom(&rnd) & 1U) != 0U)
+        {
+            n = spsc_pop(&queue, &block[0]) ? 1U : 0U;
+        }
+        else
+        {
+            n = spsc_popBlock(&queue, block,
+                              (uint16_t)(1U + nextRandom(&rnd) % MAX_BLOCK));
+        }
+        if (n == 0U)
+        {
+            sched_yield();          // Empty: let the producer run
+        }
+        if (spsc_count(&queue) > RING_SIZE)
+        {
+            printf("FAIL fill level %u: indices crossed\n", spsc_count(&queue));
+            return 1;
+        }
+
+        for (i = 0; i < n; i++, received++)
+        {
+            // Out of order, lost or duplicated words all break the sequence
+            if ((block[i] != (uint16_t)received) && (errors++ < 10U))
+            {
+                printf("FAIL word %lu: got %u, expected %u\n",
+                       (unsigned long)received, block[i],
+                       (uint16_t)received);
+            }
+        }
+    }
+    pthread_join(thread, NULL);
+
+    if (spsc_count(&queue) != 0U)
+    {
+        printf("FAIL %u words left in the ring\n", spsc_count(&queue));
+        errors++;
+    }
+    if ((queue.pushed != TOTAL_WORDS) || (queue.dropped != refused))
+    {
+        printf("FAIL pushed %lu, dropped %lu (refused %lu)\n",
+               (unsigned long)queue.pushed, (unsigned long)queue.dropped,
+               (unsigned long)refused);
+        errors++;
+    }
+    if (queue.highWater > RING_SIZE)
+    {
+        printf("FAIL highWater %u above the ring size\n", queue.highWater);
+        errors++;
+    }
+
+    printf("%lu words, %lu refused, highWater %u: %s\n",
+           (unsigned long)received, (unsigned long)refused, queue.highWater,
+           (errors == 0U) ? "PASS" : "FAILED");
+    return (errors == 0U) ? 0 : 1;
+}